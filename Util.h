@@ -20,11 +20,19 @@
 
 /* Includes the classes of the Util library */
 #include <classes/ReturnVal.h>
+#include <classes/VecArray.h>
+#include <classes/VecExpr.h>
+#include <classes/VecMath.h>
 #include <classes/Colour.h>
+#include <classes/Mat.h>
 #include <classes/Vec.h>
 
 /* Includes the additional sections of the Util library */
+#include <sections/LogDeferred.h>
 #include <sections/FileRead.h>
+#include <sections/LogSink.h>
+#include <sections/Metrics.h>
+#include <sections/Trace.h>
 #include <sections/Misc.h>
 #include <sections/Log.h>
 
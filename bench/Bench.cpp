@@ -0,0 +1,282 @@
+#include <bench/Bench.h>
+
+#include <string_view>
+#include <algorithm>
+#include <iostream>
+#include <fstream>
+#include <cstdlib>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <new>
+
+#if defined(_WIN32) || defined(_WIN64)
+    #include <malloc.h>
+#endif
+
+/* Replaces the global allocation functions so each benchmark can report how often it allocates */
+
+static std::atomic<std::uint64_t> allocations = 0;
+
+void* operator new(std::size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size == 0 ? 1 : size))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t align)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    const std::size_t alignment = static_cast<std::size_t>(align);
+
+    #if defined(_WIN32) || defined(_WIN64)
+        void* ptr = _aligned_malloc(size == 0 ? 1 : size, alignment);
+    #else
+        void* ptr = std::aligned_alloc(alignment, ((size + alignment - 1) / alignment) * alignment);
+    #endif
+
+    if (ptr == nullptr)
+        throw std::bad_alloc();
+
+    return ptr;
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+#if defined(_WIN32) || defined(_WIN64)
+    void operator delete(void* ptr, std::align_val_t) noexcept { _aligned_free(ptr); }
+    void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { _aligned_free(ptr); }
+#else
+    void operator delete(void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+    void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { std::free(ptr); }
+#endif
+
+namespace PashaBibko::Util::Bench
+{
+    struct Benchmark
+    {
+        std::string name;
+        Function function;
+    };
+
+    /* Function local so benchmarks can register from static variables in any order */
+    static std::vector<Benchmark>& Benchmarks()
+    {
+        static std::vector<Benchmark> benchmarks;
+        return benchmarks;
+    }
+
+    void Register(const std::string& name, Function function)
+    {
+        Benchmarks().push_back({ name, std::move(function) });
+    }
+
+    std::uint64_t AllocationCount()
+    {
+        return allocations.load(std::memory_order_relaxed);
+    }
+
+    void State::PauseTiming()
+    {
+        m_PauseAllocations = AllocationCount();
+        m_PauseStart = std::chrono::steady_clock::now();
+    }
+
+    void State::ResumeTiming()
+    {
+        m_PausedTime += std::chrono::steady_clock::now() - m_PauseStart;
+        m_PausedAllocations += AllocationCount() - m_PauseAllocations;
+    }
+
+    struct Measurement
+    {
+        std::uint64_t iterations;
+        double seconds;
+        std::uint64_t allocations;
+    };
+
+    static Measurement Measure(const Function& function, State& state)
+    {
+        const std::uint64_t allocsBefore = AllocationCount();
+        const auto start = std::chrono::steady_clock::now();
+
+        function(state);
+
+        const auto end = std::chrono::steady_clock::now();
+        const std::uint64_t allocsAfter = AllocationCount();
+
+        const double seconds = std::chrono::duration<double>(end - start - state.PausedTime()).count();
+        return { state.Iterations(), seconds, allocsAfter - allocsBefore - state.PausedAllocations() };
+    }
+
+    /* What is reported for each benchmark, kept so it can also be written as JSON */
+    struct Result
+    {
+        std::string name;
+        std::uint64_t iterations;
+        double nsPerOp;
+        double allocsPerOp;
+        double mbPerSecond;
+        std::map<std::string, double> counters;
+    };
+
+    /* Increases the iteration count until a run takes at least minTime, the last run is reported */
+    static Result Run(const Benchmark& benchmark, double minTime)
+    {
+        std::uint64_t iterations = 1;
+        for (;;)
+        {
+            State state(iterations);
+            const Measurement result = Measure(benchmark.function, state);
+
+            if (result.seconds < minTime && iterations < (1ull << 40))
+            {
+                /* Aims slightly past the minimum time so it does not take many small steps */
+                const double perIteration = std::max(result.seconds / static_cast<double>(iterations), 1e-9);
+                const double predicted = (minTime * 1.4) / perIteration;
+                iterations = std::clamp<std::uint64_t>(static_cast<std::uint64_t>(predicted), iterations * 2, iterations * 100);
+                continue;
+            }
+
+            const double nsPerOp = (result.seconds * 1e9) / static_cast<double>(result.iterations);
+            const double allocsPerOp = static_cast<double>(result.allocations) / static_cast<double>(result.iterations);
+
+            std::printf("%-48s %12llu %14.2f ns/op %10.3f allocs/op", benchmark.name.c_str(),
+                static_cast<unsigned long long>(result.iterations), nsPerOp, allocsPerOp);
+
+            double mbPerSecond = 0.0;
+            if (state.BytesPerIteration() != 0)
+            {
+                const double bytes = static_cast<double>(state.BytesPerIteration()) * static_cast<double>(result.iterations);
+                mbPerSecond = (bytes / (1024.0 * 1024.0)) / result.seconds;
+                std::printf(" %10.1f MB/s", mbPerSecond);
+            }
+
+            for (const auto& [name, value] : state.Counters())
+                std::printf(" %s=%g", name.c_str(), value);
+
+            std::printf("\n");
+            std::fflush(stdout);
+            return { benchmark.name, result.iterations, nsPerOp, allocsPerOp, mbPerSecond, state.Counters() };
+        }
+    }
+
+    /* Names only contain printable characters so only quotes and backslashes need escaping */
+    static void WriteJsonString(std::ostream& os, const std::string& string)
+    {
+        os << '"';
+        for (const char c : string)
+        {
+            if (c == '"' || c == '\\')
+                os << '\\';
+
+            os << c;
+        }
+
+        os << '"';
+    }
+
+    /* Writes the results in a stable format so runs from different versions can be compared */
+    static bool WriteJson(const std::string& path, const std::vector<Result>& results, double minTime)
+    {
+        std::ofstream file(path, std::ios::trunc);
+        if (!file)
+            return false;
+
+        file << "{\n  \"context\": {\n";
+        file << "    \"compiler\": ";
+
+        #if defined(__clang__)
+            WriteJsonString(file, "clang " __clang_version__);
+        #elif defined(__GNUC__)
+            WriteJsonString(file, "gcc " __VERSION__);
+        #elif defined(_MSC_VER)
+            WriteJsonString(file, "msvc " + std::to_string(_MSC_VER));
+        #else
+            WriteJsonString(file, "unknown");
+        #endif
+
+        #if defined(NDEBUG)
+            file << ",\n    \"build\": \"release\"";
+        #else
+            file << ",\n    \"build\": \"debug\"";
+        #endif
+
+        file << ",\n    \"min_time\": " << minTime << "\n  },\n  \"benchmarks\": [";
+
+        for (std::size_t index = 0; index < results.size(); index++)
+        {
+            const Result& result = results[index];
+
+            file << (index == 0 ? "\n" : ",\n") << "    { \"name\": ";
+            WriteJsonString(file, result.name);
+            file << ", \"iterations\": " << result.iterations;
+            file << ", \"ns_per_op\": " << result.nsPerOp;
+            file << ", \"allocs_per_op\": " << result.allocsPerOp;
+            file << ", \"mb_per_s\": " << result.mbPerSecond;
+
+            for (const auto& [name, value] : result.counters)
+            {
+                file << ", ";
+                WriteJsonString(file, name);
+                file << ": " << value;
+            }
+
+            file << " }";
+        }
+
+        file << "\n  ]\n}\n";
+        return static_cast<bool>(file);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    using namespace PashaBibko::Util;
+
+    std::string_view filter;
+    std::string jsonPath;
+    double minTime = 0.25;
+
+    /*
+     * Parses the command line, --filter=<text> only runs benchmarks with the text in their name
+     * and --json=<path> also writes the results to a JSON file once every benchmark has run.
+     */
+    for (int index = 1; index < argc; index++)
+    {
+        const std::string_view arg = argv[index];
+        if (arg.starts_with("--filter="))
+            filter = arg.substr(9);
+
+        else if (arg.starts_with("--min-time="))
+            minTime = std::strtod(argv[index] + 11, nullptr);
+
+        else if (arg.starts_with("--json="))
+            jsonPath = arg.substr(7);
+
+        else
+        {
+            std::cerr << "Usage: " << argv[0] << " [--filter=<text>] [--min-time=<seconds>] [--json=<path>]\n";
+            return 1;
+        }
+    }
+
+    std::vector<Bench::Result> results;
+    for (const Bench::Benchmark& benchmark : Bench::Benchmarks())
+    {
+        if (benchmark.name.find(filter) != std::string::npos)
+            results.push_back(Bench::Run(benchmark, minTime));
+    }
+
+    if (!jsonPath.empty() && !Bench::WriteJson(jsonPath, results, minTime))
+    {
+        std::cerr << "Failed to write results to " << jsonPath << "\n";
+        return 1;
+    }
+
+    return 0;
+}
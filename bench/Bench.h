@@ -0,0 +1,150 @@
+#pragma once
+
+#include <functional>
+#include <streambuf>
+#include <iostream>
+#include <cstdint>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <thread>
+#include <map>
+
+/**
+ * @file Bench.h
+ * 
+ * @brief Minimal benchmark harness used by the PashaBibko-UTIL-Bench target.
+ *        Not part of the library so it is not included by Util.h.
+ */
+
+namespace PashaBibko::Util::Bench
+{
+    /* Passed to each benchmark, holds how many iterations to run and what it reported */
+    class State final
+    {
+        public:
+            explicit State(std::uint64_t iterations)
+                : m_Iterations(iterations)
+            {}
+
+            /* How many times the benchmark should run the code being measured */
+            std::uint64_t Iterations() const { return m_Iterations; }
+
+            /* Allows MB/s to be reported, the amount of bytes processed by a single iteration */
+            void SetBytesPerIteration(std::uint64_t bytes) { m_BytesPerIteration = bytes; }
+            std::uint64_t BytesPerIteration() const { return m_BytesPerIteration; }
+
+            /* Extra values that are printed alongside the timing */
+            void SetCounter(const std::string& name, double value) { m_Counters[name] = value; }
+            const std::map<std::string, double>& Counters() const { return m_Counters; }
+
+            /* Excludes setup such as creating fixtures from the time and allocations that are reported */
+            void PauseTiming();
+            void ResumeTiming();
+
+            std::chrono::steady_clock::duration PausedTime() const { return m_PausedTime; }
+            std::uint64_t PausedAllocations() const { return m_PausedAllocations; }
+
+        private:
+            const std::uint64_t m_Iterations;
+            std::chrono::steady_clock::time_point m_PauseStart;
+            std::chrono::steady_clock::duration m_PausedTime{};
+            std::uint64_t m_PauseAllocations = 0;
+            std::uint64_t m_PausedAllocations = 0;
+            std::uint64_t m_BytesPerIteration = 0;
+            std::map<std::string, double> m_Counters;
+    };
+
+    using Function = std::function<void(State&)>;
+
+    /* Adds a benchmark to the list that is run by main() */
+    void Register(const std::string& name, Function function);
+
+    /* Allows benchmarks to register themselves from a static variable */
+    struct Registrar final
+    {
+        Registrar(const std::string& name, Function function)
+        {
+            Register(name, std::move(function));
+        }
+    };
+
+    /* Discards everything written to it but counts the bytes so MB/s can be reported */
+    class NullBuffer final : public std::streambuf
+    {
+        public:
+            std::uint64_t Written() const { return m_Written; }
+
+        protected:
+            int_type overflow(int_type c) override
+            {
+                m_Written++;
+                return traits_type::not_eof(c);
+            }
+
+            std::streamsize xsputn(const char*, std::streamsize count) override
+            {
+                m_Written += static_cast<std::uint64_t>(count);
+                return count;
+            }
+
+        private:
+            std::uint64_t m_Written = 0;
+    };
+
+    /* Redirects std::cout for the lifetime of the object so console output does not affect the timings */
+    class SilenceConsole final
+    {
+        public:
+            SilenceConsole() : m_Previous(std::cout.rdbuf(&m_Null)) {}
+            ~SilenceConsole() { std::cout.rdbuf(m_Previous); }
+
+            /* Bytes written to std::cout whilst it was silenced */
+            std::uint64_t Written() const { return m_Null.Written(); }
+
+        private:
+            NullBuffer m_Null;
+            std::streambuf* m_Previous;
+    };
+
+    /* Total amount of heap allocations made by the process so far */
+    std::uint64_t AllocationCount();
+
+    /* Stops the compiler from removing the calculation of a value that is never used */
+    template<typename Ty>
+    inline void DoNotOptimize(const Ty& value)
+    {
+        #if defined(_MSC_VER) && !defined(__clang__)
+            static volatile const void* sink;
+            sink = &value;
+        #else
+            asm volatile("" : : "r,m"(value) : "memory");
+        #endif
+    }
+
+    /*
+     * Splits the iterations across the threads, each one calls the function with the index of each
+     * of its iterations. The first threads take the remainder so every iteration runs exactly once.
+     */
+    template<typename Func>
+    inline void RunOnThreads(State& state, unsigned threadCount, Func function)
+    {
+        const std::uint64_t iterations = state.Iterations();
+
+        std::vector<std::thread> threads;
+        for (unsigned thread = 0; thread < threadCount; thread++)
+        {
+            const std::uint64_t count = iterations / threadCount + (thread < iterations % threadCount ? 1 : 0);
+            threads.emplace_back([function, count]()
+            {
+                for (std::uint64_t index = 0; index < count; index++)
+                    function(index);
+            });
+        }
+
+        for (std::thread& thread : threads)
+            thread.join();
+
+        state.SetCounter("threads", threadCount);
+    }
+}
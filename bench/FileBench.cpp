@@ -0,0 +1,305 @@
+#include <bench/Bench.h>
+
+#include <Util.h>
+
+#include <filesystem>
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <map>
+
+#if defined(__linux__)
+    #include <sys/resource.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+    #include <fcntl.h>
+#endif
+
+/*
+ * Benchmarks for reading whole files with ReadFile() compared to other ways of reading them.
+ *
+ * Fixtures are written to a tmpfs directory (/dev/shm) by default so the warm results are not
+ * affected by the disk. The cold benchmarks drop the file from the page cache before each read,
+ * which does nothing on tmpfs, so set PBU_BENCH_DIR to a directory on a real disk to measure them.
+ * The 1 GiB files are only included if PBU_BENCH_LARGE_FILES is set as they need 2 GiB of memory.
+ */
+
+namespace PashaBibko::Util::Bench
+{
+    /* Creates each fixture the first time it is needed and removes them all when the benchmarks end */
+    class FileFixtures final
+    {
+        public:
+            FileFixtures()
+            {
+                if (const char* dir = std::getenv("PBU_BENCH_DIR"))
+                    m_Directory = dir;
+
+                else if (std::filesystem::is_directory("/dev/shm"))
+                    m_Directory = "/dev/shm";
+
+                else
+                    m_Directory = std::filesystem::temp_directory_path();
+
+                m_Directory /= "pbu-file-bench";
+                std::filesystem::create_directories(m_Directory);
+            }
+
+            ~FileFixtures()
+            {
+                std::error_code error;
+                std::filesystem::remove_all(m_Directory, error);
+            }
+
+            /* Lines of text with varying length so the contents are similar to a real file */
+            const std::filesystem::path& Get(std::uint64_t size)
+            {
+                std::filesystem::path& path = m_Paths[size];
+                if (!path.empty())
+                    return path;
+
+                path = m_Directory / (std::to_string(size) + ".txt");
+                std::ofstream file(path, std::ios::binary | std::ios::trunc);
+
+                std::string chunk;
+                for (std::size_t line = 0; chunk.size() < (1 << 20); line++)
+                {
+                    chunk.append(8 + (line * 37) % 96, static_cast<char>('a' + line % 26));
+                    chunk.push_back('\n');
+                }
+
+                for (std::uint64_t written = 0; written < size; written += chunk.size())
+                    file.write(chunk.data(), static_cast<std::streamsize>(std::min<std::uint64_t>(chunk.size(), size - written)));
+
+                return path;
+            }
+
+        private:
+            std::filesystem::path m_Directory;
+            std::map<std::uint64_t, std::filesystem::path> m_Paths;
+    };
+
+    static FileFixtures& Fixtures()
+    {
+        static FileFixtures fixtures;
+        return fixtures;
+    }
+
+    /* How ReadFile() worked before it used open() and read(), kept as a baseline */
+    static std::string LegacyIfstreamRead(const std::filesystem::path& path)
+    {
+        if (!std::filesystem::exists(path) || !std::filesystem::is_regular_file(path))
+            return {};
+
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file)
+            return {};
+
+        const std::streamsize len = file.tellg();
+        file.seekg(0, std::ios::beg);
+
+        std::string contents(static_cast<std::size_t>(len), '\0');
+        file.read(&contents[0], len);
+        return contents;
+    }
+
+    static std::string UtilReadFile(const std::filesystem::path& path)
+    {
+        ReturnVal<std::string, FileReadError> contents = ReadFile(path);
+        return contents.Failed() ? std::string() : std::move(contents.Result());
+    }
+
+    /* Maps the file without copying, touches one byte of each page so every page is actually read */
+    static std::string UtilMapFile(const std::filesystem::path& path)
+    {
+        ReturnVal<MappedFile, FileReadError> file = MapFile(path, MapHint::Sequential);
+        if (file.Failed())
+            return {};
+
+        const char* data = file.Result().Data();
+        char sum = 0;
+
+        for (std::size_t index = 0; index < file.Result().Size(); index += 4096)
+            sum = static_cast<char>(sum + data[index]);
+
+        DoNotOptimize(sum);
+        return {};
+    }
+
+    #if defined(__linux__)
+
+    /* A single open() and fstat() followed by read() until the whole file has been read */
+    static std::string PosixRead(const std::filesystem::path& path)
+    {
+        const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        struct stat info;
+        fstat(fd, &info);
+
+        std::string contents(static_cast<std::size_t>(info.st_size), '\0');
+        for (std::size_t total = 0; total < contents.size();)
+        {
+            const ssize_t count = read(fd, contents.data() + total, contents.size() - total);
+            if (count <= 0)
+                break;
+
+            total += static_cast<std::size_t>(count);
+        }
+
+        close(fd);
+        return contents;
+    }
+
+    /* pread() in 1 MiB blocks, the size a reader that does not trust st_size would use */
+    static std::string PosixPread(const std::filesystem::path& path)
+    {
+        constexpr std::size_t blockSize = 1 << 20;
+
+        const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        struct stat info;
+        fstat(fd, &info);
+
+        std::string contents(static_cast<std::size_t>(info.st_size), '\0');
+        for (std::size_t total = 0; total < contents.size();)
+        {
+            const ssize_t count = pread(fd, contents.data() + total, std::min(blockSize, contents.size() - total), static_cast<off_t>(total));
+            if (count <= 0)
+                break;
+
+            total += static_cast<std::size_t>(count);
+        }
+
+        close(fd);
+        return contents;
+    }
+
+    /* mmap() the whole file and copy it into the string, without any madvise() hints */
+    static std::string PosixMmapCopy(const std::filesystem::path& path)
+    {
+        const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        struct stat info;
+        fstat(fd, &info);
+
+        const std::size_t len = static_cast<std::size_t>(info.st_size);
+        void* view = mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+
+        if (view == MAP_FAILED)
+            return {};
+
+        std::string contents(static_cast<const char*>(view), len);
+        munmap(view, len);
+        return contents;
+    }
+
+    /* Drops the file from the page cache so the next read has to go to the disk */
+    static void EvictFromCache(const std::filesystem::path& path)
+    {
+        const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        close(fd);
+    }
+
+    /* Amount of read syscalls (read, pread, readv...) made by the process, mmap and page faults are not included */
+    static std::uint64_t ReadSyscallCount()
+    {
+        std::ifstream io("/proc/self/io");
+        std::string key;
+        std::uint64_t value = 0;
+
+        while (io >> key >> value)
+        {
+            if (key == "syscr:")
+                return value;
+        }
+
+        return 0;
+    }
+
+    static std::uint64_t PageFaultCount()
+    {
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        return static_cast<std::uint64_t>(usage.ru_minflt + usage.ru_majflt);
+    }
+
+    #endif
+
+    using ReadFunction = std::string(*)(const std::filesystem::path&);
+
+    static void RunFileRead(State& state, std::uint64_t size, bool cold, ReadFunction function)
+    {
+        state.PauseTiming();
+        const std::filesystem::path& path = Fixtures().Get(size);
+        state.ResumeTiming();
+
+        state.SetBytesPerIteration(size);
+
+        #if defined(__linux__)
+            const std::uint64_t syscallsBefore = ReadSyscallCount();
+            const std::uint64_t faultsBefore = PageFaultCount();
+        #endif
+
+        for (std::uint64_t index = 0; index < state.Iterations(); index++)
+        {
+            #if defined(__linux__)
+                if (cold)
+                    EvictFromCache(path);
+            #endif
+
+            std::string contents = function(path);
+            DoNotOptimize(contents.data());
+        }
+
+        #if defined(__linux__)
+            /* Reading /proc/self/io is a read syscall itself so it is not counted */
+            const double iterations = static_cast<double>(state.Iterations());
+            state.SetCounter("read_syscalls", static_cast<double>(ReadSyscallCount() - syscallsBefore - 1) / iterations);
+            state.SetCounter("page_faults", static_cast<double>(PageFaultCount() - faultsBefore) / iterations);
+        #endif
+    }
+
+    static std::string SizeName(std::uint64_t size)
+    {
+        if (size >= (1 << 30)) return std::to_string(size >> 30) + "GiB";
+        if (size >= (1 << 20)) return std::to_string(size >> 20) + "MiB";
+        return std::to_string(size >> 10) + "KiB";
+    }
+
+    static const bool fileBenchmarks = []()
+    {
+        std::vector<std::pair<const char*, ReadFunction>> strategies =
+        {
+            { "readfile", UtilReadFile },
+            { "mapfile", UtilMapFile },
+            { "ifstream-legacy", LegacyIfstreamRead },
+
+            #if defined(__linux__)
+                { "read", PosixRead },
+                { "pread-1MiB", PosixPread },
+                { "mmap-copy", PosixMmapCopy },
+            #endif
+        };
+
+        std::vector<std::uint64_t> sizes = { 1ull << 10, 64ull << 10, 1ull << 20, 16ull << 20, 256ull << 20 };
+        if (std::getenv("PBU_BENCH_LARGE_FILES") != nullptr)
+            sizes.push_back(1ull << 30);
+
+        for (const std::uint64_t size : sizes)
+        {
+            for (const auto& [name, function] : strategies)
+            {
+                const std::string base = std::string("file/read/") + name + "/" + SizeName(size);
+                Register(base, [size, function](State& state) { RunFileRead(state, size, false, function); });
+
+                #if defined(__linux__)
+                    Register(base + "/cold", [size, function](State& state) { RunFileRead(state, size, true, function); });
+                #endif
+            }
+        }
+
+        return true;
+    }();
+}
@@ -0,0 +1,88 @@
+#include <bench/Bench.h>
+
+#include <Util.h>
+
+#include <sstream>
+
+/* Benchmarks for formatting and writing messages with Util::Log() */
+
+namespace PashaBibko::Util::Bench
+{
+    /* How messages were formatted before the to_chars based formatter, kept as a baseline */
+    template<typename... Args>
+    static std::string LegacyFormat(Args&&... args)
+    {
+        auto process = [](const auto& arg)
+        {
+            std::ostringstream os{};
+            os << arg;
+            return std::move(os).str();
+        };
+
+        return (process(args) + ... + "");
+    }
+
+    static Registrar legacyFormat("log/format/legacy-ostringstream", [](State& state)
+    {
+        for (std::uint64_t index = 0; index < state.Iterations(); index++)
+        {
+            std::string message = LegacyFormat("x=", index, " y=", 2, " z=", 3.5, ' ', true);
+            DoNotOptimize(message);
+        }
+    });
+
+    static Registrar threadBufferFormat("log/format/thread-buffer", [](State& state)
+    {
+        for (std::uint64_t index = 0; index < state.Iterations(); index++)
+        {
+            Internal::FormatBuffer buffer;
+            Internal::AppendArgs(buffer.Get(), "x=", index, " y=", 2, " z=", 3.5, ' ', true);
+            DoNotOptimize(buffer.Get());
+        }
+    });
+
+    static Registrar fixedBufferFormat("log/format/fixed-buffer", [](State& state)
+    {
+        char buffer[256];
+        for (std::uint64_t index = 0; index < state.Iterations(); index++)
+        {
+            std::size_t len = FormatTo(buffer, "x=", index, " y=", 2, " z=", 3.5, ' ', true);
+            DoNotOptimize(len);
+            DoNotOptimize(buffer);
+        }
+    });
+
+    /* Whole Log() call, the console is silenced and on Linux / macOS the log file is /dev/null (see CMakeLists.txt) */
+    static Registrar logPrimitives("log/log/primitives", [](State& state)
+    {
+        SilenceConsole silence;
+        for (std::uint64_t index = 0; index < state.Iterations(); index++)
+            Log("x=", index, " y=", 2, " z=", 3.5, ' ', true);
+    });
+
+    /* Cost of a call that is filtered out by the runtime level */
+    static Registrar runtimeFiltered("log/level/runtime-filtered", [](State& state)
+    {
+        const LogLevel previous = GetLogLevel();
+        SetLogLevel(LogLevel::Warn);
+
+        for (std::uint64_t index = 0; index < state.Iterations(); index++)
+            PBU_LOG_DEBUG("x=", index, " y=", 2, " z=", 3.5);
+
+        SetLogLevel(previous);
+    });
+
+    /* Cost on the calling thread of copying the arguments for the background formatter */
+    static Registrar deferredPrimitives("log/deferred/primitives", [](State& state)
+    {
+        SilenceConsole silence;
+        EnableDeferredLogging({ .bufferSize = 1 << 24 });
+
+        const std::size_t droppedBefore = DroppedDeferredLogCount();
+        for (std::uint64_t index = 0; index < state.Iterations(); index++)
+            LogDeferred<LogLevel::Info>("x=", index, " y=", 2, " z=", 3.5, ' ', true);
+
+        state.SetCounter("dropped", static_cast<double>(DroppedDeferredLogCount() - droppedBefore));
+        DisableDeferredLogging();
+    });
+}
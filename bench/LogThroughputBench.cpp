@@ -0,0 +1,119 @@
+#include <bench/Bench.h>
+
+#include <Util.h>
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+/*
+ * Throughput and latency of whole Log() calls for different kinds of arguments. The console is
+ * silenced and on Linux / macOS the log file of the benchmark is /dev/null (see CMakeLists.txt)
+ * so only the cost of the logger is measured. Every run logs the same values so it is reproducible.
+ */
+
+namespace PashaBibko::Util::Bench
+{
+    struct LogStrArg
+    {
+        std::string LogStr() const
+        {
+            return "LogStrArg{ id=42, name=example }";
+        }
+    };
+
+    /* The arguments of each case, index is the number of the message so it is not constant */
+
+    static void LogPrimitives(std::uint64_t index)
+    {
+        Log("x=", index, " y=", 2, " z=", 3.5, ' ', true);
+    }
+
+    static void LogStrings(std::uint64_t index)
+    {
+        static const std::string user = "example-user";
+        static constexpr std::string_view action = "opened file";
+
+        Log("user=", user, " action=", action, " path=", "/tmp/example.txt", " attempt=", index);
+    }
+
+    static void LogPointers(std::uint64_t index)
+    {
+        static const int value = 7;
+        static const LogStrArg object;
+
+        Log("value=", &value, " object=", &object, " index=", index);
+    }
+
+    static void LogStrTypes(std::uint64_t index)
+    {
+        static const LogStrArg object;
+        Log(object, " index=", index);
+    }
+
+    static void LogContainer(std::uint64_t)
+    {
+        static const std::vector<int> values = { 1, 2, 3, 5, 8, 13, 21, 34, 55, 89, 144, 233, 377, 610, 987, 1597 };
+        Log("values", values);
+    }
+
+    /* Splits the iterations across the threads and reports the combined rate */
+    static void RunThroughput(State& state, unsigned threadCount, void(*function)(std::uint64_t))
+    {
+        const std::uint64_t iterations = state.Iterations();
+        SilenceConsole silence;
+
+        const auto start = std::chrono::steady_clock::now();
+        RunOnThreads(state, threadCount, function);
+
+        FlushLogs();
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        state.SetBytesPerIteration(silence.Written() / iterations);
+        state.SetCounter("msgs_per_s", static_cast<double>(iterations) / seconds);
+    }
+
+    /* Times every call on its own, includes the overhead of reading the clock (around 20ns) */
+    static void RunLatency(State& state, void(*function)(std::uint64_t))
+    {
+        const std::uint64_t iterations = state.Iterations();
+        std::vector<std::uint64_t> samples(iterations);
+        SilenceConsole silence;
+
+        for (std::uint64_t index = 0; index < iterations; index++)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            function(index);
+            const auto end = std::chrono::steady_clock::now();
+
+            samples[index] = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+        }
+
+        FlushLogs();
+        std::sort(samples.begin(), samples.end());
+
+        auto percentile = [&](double fraction) { return static_cast<double>(samples[static_cast<std::size_t>(fraction * static_cast<double>(iterations - 1))]); };
+        state.SetBytesPerIteration(silence.Written() / iterations);
+        state.SetCounter("p50_ns", percentile(0.50));
+        state.SetCounter("p99_ns", percentile(0.99));
+        state.SetCounter("p999_ns", percentile(0.999));
+    }
+
+    static void RegisterLogCase(const std::string& name, void(*function)(std::uint64_t))
+    {
+        Register("log/throughput/" + name + "/threads:1", [function](State& state) { RunThroughput(state, 1, function); });
+        Register("log/throughput/" + name + "/threads:4", [function](State& state) { RunThroughput(state, 4, function); });
+        Register("log/latency/" + name, [function](State& state) { RunLatency(state, function); });
+    }
+
+    static const bool logThroughputBenchmarks = []()
+    {
+        RegisterLogCase("primitives", LogPrimitives);
+        RegisterLogCase("strings", LogStrings);
+        RegisterLogCase("pointers", LogPointers);
+        RegisterLogCase("logstr", LogStrTypes);
+        RegisterLogCase("container", LogContainer);
+        return true;
+    }();
+}
@@ -0,0 +1,41 @@
+#include <bench/Bench.h>
+
+#include <Util.h>
+
+#include <atomic>
+
+/* Cost of updating metrics from several threads, compared to a single shared atomic */
+
+namespace PashaBibko::Util::Bench
+{
+    static void RegisterMetricCases(unsigned threads)
+    {
+        const std::string suffix = "/threads:" + std::to_string(threads);
+
+        Register("metrics/counter" + suffix, [threads](State& state)
+        {
+            static Counter& counter = Metrics::GetCounter("bench.counter");
+            RunOnThreads(state, threads, [](std::uint64_t) { counter.Add(); });
+        });
+
+        /* Baseline of every thread adding to the same cache line */
+        Register("metrics/shared-atomic" + suffix, [threads](State& state)
+        {
+            static std::atomic<std::uint64_t> counter = 0;
+            RunOnThreads(state, threads, [](std::uint64_t) { counter.fetch_add(1, std::memory_order_relaxed); });
+        });
+
+        Register("metrics/histogram" + suffix, [threads](State& state)
+        {
+            static Histogram& histogram = Metrics::GetHistogram("bench.histogram");
+            RunOnThreads(state, threads, [](std::uint64_t index) { histogram.Record(index & 0xFFFF); });
+        });
+    }
+
+    static const bool metricsBenchmarks = []()
+    {
+        RegisterMetricCases(1);
+        RegisterMetricCases(4);
+        return true;
+    }();
+}
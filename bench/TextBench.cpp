@@ -0,0 +1,165 @@
+#include <bench/Bench.h>
+
+#include <Util.h>
+
+#include <cstring>
+#include <string>
+
+/* Benchmarks for finding new lines, the scalar loops are how it was done before the vectorized kernels */
+
+namespace PashaBibko::Util::Bench
+{
+    /* 16 MiB of text with lines of varying length, similar to source code */
+    static const std::string& SampleText()
+    {
+        static const std::string text = []()
+        {
+            std::string out;
+            out.reserve(16 << 20);
+
+            for (std::size_t line = 0; out.size() < (16 << 20); line++)
+            {
+                out.append(8 + (line * 37) % 96, 'x');
+                out.push_back('\n');
+            }
+
+            out.resize(16 << 20);
+            return out;
+        }();
+
+        return text;
+    }
+
+    /* The loop used by GetLocationAtStringIndex() before it used the kernels */
+    static StringLocation LegacyLocation(const std::string& string, std::uint32_t index)
+    {
+        StringLocation location = { 1, 1 };
+        if (index > string.length())
+            return { 0, 0 };
+
+        for (std::uint32_t it = 0; it != index; it++)
+        {
+            if (string[it] == '\n')
+            {
+                location.colummn = 0;
+                location.line++;
+            }
+
+            location.colummn++;
+        }
+
+        return location;
+    }
+
+    static Registrar countScalar("text/count/scalar-loop", [](State& state)
+    {
+        const std::string& text = SampleText();
+        state.SetBytesPerIteration(text.size());
+
+        for (std::uint64_t index = 0; index < state.Iterations(); index++)
+        {
+            std::size_t count = 0;
+            for (const char c : text)
+            {
+                if (c == '\n')
+                    count++;
+
+                /* Stops the compiler vectorizing the loop so it stays one byte at a time */
+                DoNotOptimize(count);
+            }
+
+            DoNotOptimize(count);
+        }
+    });
+
+    static Registrar countKernel("text/count/kernel", [](State& state)
+    {
+        const std::string& text = SampleText();
+        state.SetBytesPerIteration(text.size());
+
+        for (std::uint64_t index = 0; index < state.Iterations(); index++)
+        {
+            std::size_t count = Internal::CountNewLines(text.data(), text.data() + text.size());
+            DoNotOptimize(count);
+        }
+    });
+
+    static Registrar locationLegacy("text/location/legacy-loop", [](State& state)
+    {
+        const std::string& text = SampleText();
+        state.SetBytesPerIteration(text.size());
+
+        for (std::uint64_t index = 0; index < state.Iterations(); index++)
+        {
+            StringLocation location = LegacyLocation(text, static_cast<std::uint32_t>(text.size()));
+            DoNotOptimize(location);
+        }
+    });
+
+    static Registrar locationKernel("text/location/kernel", [](State& state)
+    {
+        const std::string& text = SampleText();
+        state.SetBytesPerIteration(text.size());
+
+        for (std::uint64_t index = 0; index < state.Iterations(); index++)
+        {
+            StringLocation location = GetLocationAtStringIndex(text, static_cast<std::uint32_t>(text.size()));
+            DoNotOptimize(location);
+        }
+    });
+
+    /* Splitting into lines, each search is short so this shows the per-call overhead as well */
+    static Registrar linesMemchr("text/lines/memchr", [](State& state)
+    {
+        const std::string& text = SampleText();
+        state.SetBytesPerIteration(text.size());
+
+        for (std::uint64_t index = 0; index < state.Iterations(); index++)
+        {
+            const char* it = text.data();
+            const char* const end = it + text.size();
+
+            std::size_t lines = 0;
+            while (const void* found = std::memchr(it, '\n', static_cast<std::size_t>(end - it)))
+            {
+                it = static_cast<const char*>(found) + 1;
+                lines++;
+            }
+
+            DoNotOptimize(lines);
+        }
+    });
+
+    static Registrar linesKernel("text/lines/kernel", [](State& state)
+    {
+        const std::string& text = SampleText();
+        state.SetBytesPerIteration(text.size());
+
+        for (std::uint64_t index = 0; index < state.Iterations(); index++)
+        {
+            const char* it = text.data();
+            const char* const end = it + text.size();
+
+            std::size_t lines = 0;
+            while (const char* found = Internal::FindNewLine(it, end))
+            {
+                it = found + 1;
+                lines++;
+            }
+
+            DoNotOptimize(lines);
+        }
+    });
+
+    static Registrar lineIndexBuild("text/line-index/build", [](State& state)
+    {
+        const std::string& text = SampleText();
+        state.SetBytesPerIteration(text.size());
+
+        for (std::uint64_t index = 0; index < state.Iterations(); index++)
+        {
+            LineIndex lines(text);
+            DoNotOptimize(lines);
+        }
+    });
+}
@@ -0,0 +1,59 @@
+#include <bench/Bench.h>
+
+#include <Util.h>
+
+#include <algorithm>
+
+/* Cost of a ScopedTimer around an empty scope, with tracing stopped and with it recording */
+
+namespace PashaBibko::Util::Bench
+{
+    static void RunZones(State& state)
+    {
+        for (std::uint64_t index = 0; index < state.Iterations(); index++)
+        {
+            PBU_TRACE_ZONE("bench");
+            DoNotOptimize(index);
+        }
+    }
+
+    static Registrar traceDisabled("trace/zone/disabled", [](State& state)
+    {
+        StopTracing();
+        RunZones(state);
+    });
+
+    /* Zones recorded between each clear, keeps the buffers to around 1.5MB however many iterations are run */
+    static constexpr std::uint64_t ZoneChunk = 64 * 1024;
+
+    /* Recorded in chunks that are cleared whilst timing is paused so no zone is dropped */
+    static Registrar traceEnabled("trace/zone/enabled", [](State& state)
+    {
+        TraceConfig config;
+        config.maxZonesPerThread = static_cast<std::size_t>(ZoneChunk);
+
+        state.PauseTiming();
+        ClearTrace();
+        StartTracing(config);
+        state.ResumeTiming();
+
+        std::size_t dropped = 0;
+        for (std::uint64_t done = 0; done < state.Iterations(); done += ZoneChunk)
+        {
+            const std::uint64_t count = std::min(ZoneChunk, state.Iterations() - done);
+            for (std::uint64_t index = 0; index < count; index++)
+            {
+                PBU_TRACE_ZONE("bench");
+                DoNotOptimize(index);
+            }
+
+            state.PauseTiming();
+            dropped += DroppedTraceZoneCount();
+            ClearTrace();
+            state.ResumeTiming();
+        }
+
+        StopTracing();
+        state.SetCounter("dropped", static_cast<double>(dropped));
+    });
+}
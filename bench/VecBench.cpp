@@ -0,0 +1,130 @@
+#include <bench/Bench.h>
+
+#include <Util.h>
+
+#include <type_traits>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/* Benchmarks for Vec arithmetic over arrays of vectors (AoS), each iteration is one pass over the arrays */
+
+namespace PashaBibko::Util::Bench
+{
+    /* Small enough for the arrays to stay in L1 / L2 so the arithmetic is measured instead of memory */
+    static constexpr std::size_t vecCount = 1024;
+
+    template<typename Ty> constexpr const char* TypeName();
+    template<> constexpr const char* TypeName<short>() { return "short"; }
+    template<> constexpr const char* TypeName<int>() { return "int"; }
+    template<> constexpr const char* TypeName<float>() { return "float"; }
+    template<> constexpr const char* TypeName<double>() { return "double"; }
+
+    /* Deterministic non-zero values that are small enough for short to not overflow */
+    template<std::size_t len, typename Ty>
+    static std::vector<Vec<len, Ty>> MakeVecs(std::size_t seed)
+    {
+        std::vector<Vec<len, Ty>> vecs(vecCount);
+        for (std::size_t index = 0; index < vecCount; index++)
+        {
+            for (std::size_t element = 0; element < len; element++)
+                vecs[index][element] = static_cast<Ty>(1 + (index * 7 + element * 13 + seed) % 29);
+        }
+
+        return vecs;
+    }
+
+    template<std::size_t len, typename Ty>
+    static void RegisterVecBenchmarks()
+    {
+        const std::string suffix = std::string("/") + TypeName<Ty>() + "/" + std::to_string(len);
+
+        Register("vec/add" + suffix, [](State& state)
+        {
+            const auto lhs = MakeVecs<len, Ty>(0);
+            const auto rhs = MakeVecs<len, Ty>(1);
+            std::vector<Vec<len, Internal::AddResultT<Ty, Ty>>> out(vecCount);
+            state.SetBytesPerIteration(vecCount * (sizeof(lhs[0]) * 2 + sizeof(out[0])));
+            state.SetCounter("vecs", vecCount);
+
+            for (std::uint64_t iteration = 0; iteration < state.Iterations(); iteration++)
+            {
+                for (std::size_t index = 0; index < vecCount; index++)
+                    out[index] = lhs[index] + rhs[index];
+
+                DoNotOptimize(out.data());
+            }
+        });
+
+        Register("vec/mul" + suffix, [](State& state)
+        {
+            const auto lhs = MakeVecs<len, Ty>(0);
+            const auto rhs = MakeVecs<len, Ty>(1);
+            std::vector<Vec<len, Internal::MulResultT<Ty, Ty>>> out(vecCount);
+            state.SetBytesPerIteration(vecCount * (sizeof(lhs[0]) * 2 + sizeof(out[0])));
+            state.SetCounter("vecs", vecCount);
+
+            for (std::uint64_t iteration = 0; iteration < state.Iterations(); iteration++)
+            {
+                for (std::size_t index = 0; index < vecCount; index++)
+                    out[index] = lhs[index] * rhs[index];
+
+                DoNotOptimize(out.data());
+            }
+        });
+
+        Register("vec/dot" + suffix, [](State& state)
+        {
+            const auto lhs = MakeVecs<len, Ty>(0);
+            const auto rhs = MakeVecs<len, Ty>(1);
+            state.SetBytesPerIteration(vecCount * sizeof(lhs[0]) * 2);
+            state.SetCounter("vecs", vecCount);
+
+            for (std::uint64_t iteration = 0; iteration < state.Iterations(); iteration++)
+            {
+                Internal::MulResultT<Ty, Ty> sum{};
+                for (std::size_t index = 0; index < vecCount; index++)
+                    sum += Dot(lhs[index], rhs[index]);
+
+                DoNotOptimize(sum);
+            }
+        });
+
+        /* Compares equal vectors so every element has to be checked */
+        Register("vec/compare" + suffix, [](State& state)
+        {
+            const auto lhs = MakeVecs<len, Ty>(0);
+            const auto rhs = lhs;
+            state.SetBytesPerIteration(vecCount * sizeof(lhs[0]) * 2);
+            state.SetCounter("vecs", vecCount);
+
+            for (std::uint64_t iteration = 0; iteration < state.Iterations(); iteration++)
+            {
+                std::size_t equal = 0;
+                for (std::size_t index = 0; index < vecCount; index++)
+                    equal += (lhs[index] == rhs[index]);
+
+                DoNotOptimize(equal);
+            }
+        });
+    }
+
+    template<typename Ty>
+    static void RegisterVecBenchmarksForType()
+    {
+        RegisterVecBenchmarks<2, Ty>();
+        RegisterVecBenchmarks<3, Ty>();
+        RegisterVecBenchmarks<4, Ty>();
+        RegisterVecBenchmarks<8, Ty>();
+        RegisterVecBenchmarks<16, Ty>();
+    }
+
+    static const bool vecBenchmarks = []()
+    {
+        RegisterVecBenchmarksForType<short>();
+        RegisterVecBenchmarksForType<int>();
+        RegisterVecBenchmarksForType<float>();
+        RegisterVecBenchmarksForType<double>();
+        return true;
+    }();
+}
@@ -0,0 +1,373 @@
+#pragma once
+
+#include <classes/ReturnVal.h>
+#include <classes/Vec.h>
+
+#include <type_traits>
+#include <algorithm>
+#include <utility>
+#include <cstddef>
+#include <span>
+
+/**
+ * @file Mat.h
+ *
+ * @brief Contains the defenition of Mat<rows, cols, Ty>, a fixed-size matrix
+ *        built from Vec<rows, Ty> columns, with the functions to multiply,
+ *        transpose and invert them.
+ */
+
+namespace PashaBibko::Util
+{
+    /**
+     * @brief Mathmatical matrix class stored as columns.
+     *
+     * @tparam rows The amount of rows, also the length of each column.
+     * @tparam cols The amount of columns.
+     * @tparam Ty The type of each element, must be an arithmetic type.
+     *
+     * @details Each column is a Vec<rows, Ty> and the columns are stored one after the
+     *          other, so a Mat4<float> is 16 contiguous floats in column-major order which
+     *          is the same layout used by most graphics APIs. Multiplying by a vector is a
+     *          sum of the columns scaled by each element of the vector, 4x4 float matrices
+     *          use SIMD kernels for this which also cover multiplying two matrices and
+     *          transforming whole arrays of vectors with Transform().
+     *
+     *          Everything apart from Inverse() is constexpr.
+     *
+     *          For convenience there are typedefs of Mat2<Ty>, Mat3<Ty> and Mat4<Ty>
+     *          for square matrices which default to float.
+     *
+     * @code
+     * constexpr Util::Mat4<float> translate(
+     *     Util::Vec4<float>(1.0f, 0.0f, 0.0f, 0.0f),
+     *     Util::Vec4<float>(0.0f, 1.0f, 0.0f, 0.0f),
+     *     Util::Vec4<float>(0.0f, 0.0f, 1.0f, 0.0f),
+     *     Util::Vec4<float>(5.0f, 0.0f, 0.0f, 1.0f)
+     * );
+     *
+     * Util::Mat4<float> transform = translate * rotate;
+     * Util::Transform(transform, points, points);    // Transforms the points in place
+     *
+     * Util::ReturnVal<Util::Mat4<float>> inverse = Util::Inverse(transform);
+     * @endcode
+     */
+    template<std::size_t rows, std::size_t cols, typename Ty = float>
+        requires (rows >= 2 && cols >= 2) && std::is_arithmetic_v<Ty>
+    struct Mat
+    {
+        /**
+         * @brief Creates a matrix with every element set to 0.
+         */
+        constexpr Mat() : columns{} {}
+
+        /**
+         * @brief Creates a matrix from its columns.
+         *
+         * @details Requires exactly one Vec<rows, Ty> for each column.
+         */
+        template<typename... Columns> requires Internal::AllSameType<Vec<rows, Ty>, std::remove_cvref_t<Columns>...> && (sizeof...(Columns) == cols)
+        explicit constexpr Mat(Columns&&... columns) : columns{ std::forward<Columns>(columns)... } {}
+
+        /**
+         * @brief Returns the identity matrix, 1 along the diagonal and 0 everywhere else.
+         */
+        static constexpr Mat Identity() requires (rows == cols)
+        {
+            Mat out;
+            for (std::size_t index = 0; index < rows; index++)
+                out.columns[index][index] = Ty(1);
+
+            return out;
+        }
+
+        /**
+         * @brief Returns a reference to the column at that index.
+         *
+         * @warning The function does not check if the index is within
+         *          the bounds of the matrix. Accessing elements not
+         *          within the bounds is classified as UB.
+         */
+        constexpr Vec<rows, Ty>& operator[](std::size_t column) { return columns[column]; }
+
+        /**
+         * @brief Returns a reference to the element at the row and column.
+         */
+        constexpr Ty& operator()(std::size_t row, std::size_t column) { return columns[column][row]; }
+
+        /**
+         * @brief Returns a copy of a row of the matrix.
+         */
+        constexpr Vec<cols, Ty> Row(std::size_t row) const
+        {
+            return [&]<std::size_t... index>(std::index_sequence<index...>) { return Vec<cols, Ty>{ columns[index][row]... }; } (std::make_index_sequence<cols>{});
+        }
+
+        /* Hides const versions of functions as they do not need to be documented twice */
+        #ifndef DOXYGEN_HIDE
+
+        constexpr const Vec<rows, Ty>& operator[](std::size_t column) const { return columns[column]; }
+        constexpr const Ty& operator()(std::size_t row, std::size_t column) const { return columns[column][row]; }
+
+        #endif // DOXYGEN_HIDE
+
+        Vec<rows, Ty> columns[cols];
+    };
+
+    /* Excludes the internal namespace from the documentation */
+    #ifndef DOXYGEN_HIDE
+
+    namespace Internal
+    {
+        /* The SIMD kernels treat the columns as one contiguous array */
+        static_assert(sizeof(Mat<4, 4, float>) == sizeof(float) * 16);
+
+        /* Multiplies count vectors of length cols by the matrix, out may be the same as in if rows == cols */
+        template<std::size_t rows, std::size_t cols, typename Ty>
+        constexpr void TransformVecs(const Mat<rows, cols, Ty>& mat, const Vec<cols, Ty>* in, Vec<rows, Ty>* out, std::size_t count)
+        {
+            if (count == 0)
+                return;
+
+            if constexpr (SimdTransform<rows, cols, Ty>)
+            {
+                if (!std::is_constant_evaluated())
+                {
+                    MatSimd<rows, cols, Ty>::Transform(mat.columns[0].data, in->data, out->data, count);
+                    return;
+                }
+            }
+
+            for (std::size_t index = 0; index < count; index++)
+            {
+                /* Products are added in column order to match the SIMD kernels */
+                const Vec<cols, Ty> vec = in[index];
+                Vec<rows, Ty> result;
+
+                for (std::size_t row = 0; row < rows; row++)
+                {
+                    Ty sum = static_cast<Ty>(mat.columns[0][row] * vec[0]);
+                    for (std::size_t column = 1; column < cols; column++)
+                        sum = static_cast<Ty>(sum + mat.columns[column][row] * vec[column]);
+
+                    result[row] = sum;
+                }
+
+                out[index] = result;
+            }
+        }
+
+        /* Inverse of a 2x2, 3x3 or 4x4 matrix using the adjugate, also returns the determinant to check for singular matrices */
+        template<std::size_t size, typename Ty>
+        constexpr std::pair<Mat<size, size, Ty>, Ty> InverseWithDeterminant(const Mat<size, size, Ty>& mat)
+        {
+            /* a(row, column) to keep the formulas readable */
+            auto a = [&](std::size_t row, std::size_t column) { return mat(row, column); };
+            Mat<size, size, Ty> out;
+            Ty det{};
+
+            if constexpr (size == 2)
+            {
+                det = a(0, 0) * a(1, 1) - a(0, 1) * a(1, 0);
+
+                out(0, 0) = a(1, 1);
+                out(0, 1) = -a(0, 1);
+                out(1, 0) = -a(1, 0);
+                out(1, 1) = a(0, 0);
+            }
+
+            else if constexpr (size == 3)
+            {
+                out(0, 0) = a(1, 1) * a(2, 2) - a(1, 2) * a(2, 1);
+                out(0, 1) = a(0, 2) * a(2, 1) - a(0, 1) * a(2, 2);
+                out(0, 2) = a(0, 1) * a(1, 2) - a(0, 2) * a(1, 1);
+                out(1, 0) = a(1, 2) * a(2, 0) - a(1, 0) * a(2, 2);
+                out(1, 1) = a(0, 0) * a(2, 2) - a(0, 2) * a(2, 0);
+                out(1, 2) = a(0, 2) * a(1, 0) - a(0, 0) * a(1, 2);
+                out(2, 0) = a(1, 0) * a(2, 1) - a(1, 1) * a(2, 0);
+                out(2, 1) = a(0, 1) * a(2, 0) - a(0, 0) * a(2, 1);
+                out(2, 2) = a(0, 0) * a(1, 1) - a(0, 1) * a(1, 0);
+
+                det = a(0, 0) * out(0, 0) + a(0, 1) * out(1, 0) + a(0, 2) * out(2, 0);
+            }
+
+            else
+            {
+                /* 2x2 determinants of the top two rows and the bottom two rows */
+                const Ty s0 = a(0, 0) * a(1, 1) - a(1, 0) * a(0, 1);
+                const Ty s1 = a(0, 0) * a(1, 2) - a(1, 0) * a(0, 2);
+                const Ty s2 = a(0, 0) * a(1, 3) - a(1, 0) * a(0, 3);
+                const Ty s3 = a(0, 1) * a(1, 2) - a(1, 1) * a(0, 2);
+                const Ty s4 = a(0, 1) * a(1, 3) - a(1, 1) * a(0, 3);
+                const Ty s5 = a(0, 2) * a(1, 3) - a(1, 2) * a(0, 3);
+
+                const Ty c0 = a(2, 0) * a(3, 1) - a(3, 0) * a(2, 1);
+                const Ty c1 = a(2, 0) * a(3, 2) - a(3, 0) * a(2, 2);
+                const Ty c2 = a(2, 0) * a(3, 3) - a(3, 0) * a(2, 3);
+                const Ty c3 = a(2, 1) * a(3, 2) - a(3, 1) * a(2, 2);
+                const Ty c4 = a(2, 1) * a(3, 3) - a(3, 1) * a(2, 3);
+                const Ty c5 = a(2, 2) * a(3, 3) - a(3, 2) * a(2, 3);
+
+                det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+
+                out(0, 0) = a(1, 1) * c5 - a(1, 2) * c4 + a(1, 3) * c3;
+                out(0, 1) = -a(0, 1) * c5 + a(0, 2) * c4 - a(0, 3) * c3;
+                out(0, 2) = a(3, 1) * s5 - a(3, 2) * s4 + a(3, 3) * s3;
+                out(0, 3) = -a(2, 1) * s5 + a(2, 2) * s4 - a(2, 3) * s3;
+
+                out(1, 0) = -a(1, 0) * c5 + a(1, 2) * c2 - a(1, 3) * c1;
+                out(1, 1) = a(0, 0) * c5 - a(0, 2) * c2 + a(0, 3) * c1;
+                out(1, 2) = -a(3, 0) * s5 + a(3, 2) * s2 - a(3, 3) * s1;
+                out(1, 3) = a(2, 0) * s5 - a(2, 2) * s2 + a(2, 3) * s1;
+
+                out(2, 0) = a(1, 0) * c4 - a(1, 1) * c2 + a(1, 3) * c0;
+                out(2, 1) = -a(0, 0) * c4 + a(0, 1) * c2 - a(0, 3) * c0;
+                out(2, 2) = a(3, 0) * s4 - a(3, 1) * s2 + a(3, 3) * s0;
+                out(2, 3) = -a(2, 0) * s4 + a(2, 1) * s2 - a(2, 3) * s0;
+
+                out(3, 0) = -a(1, 0) * c3 + a(1, 1) * c1 - a(1, 2) * c0;
+                out(3, 1) = a(0, 0) * c3 - a(0, 1) * c1 + a(0, 2) * c0;
+                out(3, 2) = -a(3, 0) * s3 + a(3, 1) * s1 - a(3, 2) * s0;
+                out(3, 3) = a(2, 0) * s3 - a(2, 1) * s1 + a(2, 2) * s0;
+            }
+
+            if (std::is_floating_point_v<Ty> && det != Ty(0))
+            {
+                const Ty reciprocal = Ty(1) / det;
+                for (std::size_t column = 0; column < size; column++)
+                {
+                    for (std::size_t row = 0; row < size; row++)
+                        out(row, column) *= reciprocal;
+                }
+            }
+
+            return { out, det };
+        }
+    }
+
+    #endif // DOXYGEN_HIDE
+
+    /**
+     * @brief Multiplies a matrix by a column vector.
+     *
+     * @details Returns a vector with the length of the rows of the matrix.
+     */
+    template<std::size_t rows, std::size_t cols, typename Ty>
+    constexpr Vec<rows, Ty> operator* (const Mat<rows, cols, Ty>& mat, const Vec<cols, Ty>& vec)
+    {
+        Vec<rows, Ty> out;
+        Internal::TransformVecs(mat, &vec, &out, 1);
+        return out;
+    }
+
+    /**
+     * @brief Multiplies two matrices together.
+     *
+     * @details The amount of columns of the left matrix must be the same as the
+     *          amount of rows of the right matrix. Applying the result to a vector
+     *          is the same as applying the right matrix and then the left.
+     */
+    template<std::size_t rows, std::size_t shared, std::size_t cols, typename Ty>
+    constexpr Mat<rows, cols, Ty> operator* (const Mat<rows, shared, Ty>& lhs, const Mat<shared, cols, Ty>& rhs)
+    {
+        Mat<rows, cols, Ty> out;
+        Internal::TransformVecs(lhs, rhs.columns, out.columns, cols);
+        return out;
+    }
+
+    /**
+     * @brief Checks if every element of two matrices are equal.
+     */
+    template<std::size_t rows, std::size_t cols, typename Ty>
+    constexpr bool operator== (const Mat<rows, cols, Ty>& lhs, const Mat<rows, cols, Ty>& rhs)
+    {
+        for (std::size_t column = 0; column < cols; column++)
+        {
+            if (lhs.columns[column] != rhs.columns[column])
+                return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Checks if any element of two matrices are not equal.
+     */
+    template<std::size_t rows, std::size_t cols, typename Ty>
+    constexpr bool operator!= (const Mat<rows, cols, Ty>& lhs, const Mat<rows, cols, Ty>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    /**
+     * @brief Returns the matrix with its rows and columns swapped.
+     */
+    template<std::size_t rows, std::size_t cols, typename Ty>
+    constexpr Mat<cols, rows, Ty> Transpose(const Mat<rows, cols, Ty>& mat)
+    {
+        Mat<cols, rows, Ty> out;
+        for (std::size_t row = 0; row < rows; row++)
+            out.columns[row] = mat.Row(row);
+
+        return out;
+    }
+
+    /**
+     * @brief Returns the determinant of a 2x2, 3x3 or 4x4 matrix.
+     */
+    template<std::size_t size, typename Ty>
+        requires (size >= 2 && size <= 4)
+    constexpr Ty Determinant(const Mat<size, size, Ty>& mat)
+    {
+        return Internal::InverseWithDeterminant(mat).second;
+    }
+
+    /**
+     * @brief Returns the inverse of a 2x2, 3x3 or 4x4 matrix.
+     *
+     * @details Only available for floating point matrices. Multiplying a matrix by its
+     *          inverse gives the identity matrix (within floating point error).
+     *
+     * @return The inverse or an error if the matrix has a determinant of 0
+     *         as it does not have an inverse.
+     */
+    template<std::size_t size, typename Ty>
+        requires (size >= 2 && size <= 4) && std::is_floating_point_v<Ty>
+    ReturnVal<Mat<size, size, Ty>> Inverse(const Mat<size, size, Ty>& mat)
+    {
+        std::pair<Mat<size, size, Ty>, Ty> inverse = Internal::InverseWithDeterminant(mat);
+        if (inverse.second == Ty(0))
+            return FunctionFail<>("Matrix is singular and has no inverse");
+
+        return std::move(inverse.first);
+    }
+
+    /**
+     * @brief Multiplies each vector by the matrix.
+     *
+     * @details Transforms min(in.size(), out.size()) vectors. Loads the matrix once for
+     *          the whole array, so is faster than multiplying each vector separately.
+     *          The input and output can be the same array to transform in place, other
+     *          overlapping is classified as UB.
+     */
+    template<std::size_t rows, std::size_t cols, typename Ty>
+    constexpr void Transform(const Mat<rows, cols, Ty>& mat, std::type_identity_t<std::span<const Vec<cols, Ty>>> in, std::type_identity_t<std::span<Vec<rows, Ty>>> out)
+    {
+        Internal::TransformVecs(mat, in.data(), out.data(), std::min(in.size(), out.size()));
+    }
+
+    /* Hides using aliases to avoid uneccesary bloat in doxygen documentation */
+    /* The types are mentoined in the description of Mat<rows, cols, Ty>     */
+    #ifndef DOXYGEN_HIDE
+
+    template<typename Ty = float>
+    using Mat2 = Mat<2, 2, Ty>;
+
+    template<typename Ty = float>
+    using Mat3 = Mat<3, 3, Ty>;
+
+    template<typename Ty = float>
+    using Mat4 = Mat<4, 4, Ty>;
+
+    #endif // DOXYGEN_HIDE
+}
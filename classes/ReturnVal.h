@@ -5,6 +5,7 @@
 #include <type_traits>
 #include <concepts>
 #include <utility>
+#include <new>
 
 /**
  * @file ReturnVal.h
@@ -152,6 +153,22 @@ namespace PashaBibko::Util
 				: m_Error(std::move(_error.error)), m_FunctionFailed(true)
 			{}
 
+			/**
+			 * @brief Moves the result or error of another Util::ReturnVal.
+			 * 
+			 * @details Allows a Util::ReturnVal to be stored in containers such as std::vector.
+			 */
+			ReturnVal(ReturnVal&& other) noexcept(std::is_nothrow_move_constructible_v<Res_Ty> && std::is_nothrow_move_constructible_v<Err_Ty>)
+				: m_FunctionFailed(other.m_FunctionFailed)
+			{
+				/* Only one of the union members is alive so only that one is constructed */
+				if (m_FunctionFailed)
+					new (&m_Error) Err_Ty(std::move(other.m_Error));
+
+				else
+					new (&m_Result) Res_Ty(std::move(other.m_Result));
+			}
+
 			/* Constructor is not manually called by someone using the library so it is excluded from docs */
 			#ifndef DOXYGEN_HIDE
 
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <classes/VecSimd.h>
+
 #include <type_traits>
 #include <utility>
 #include <cstddef>
@@ -13,23 +15,58 @@
 
 namespace PashaBibko::Util
 {
+    /**
+     * @brief Layout of a Vec with the natural alignment of its type and no padding.
+     *
+     * @details The default layout, a Vec<len, Ty> is the same as an array of Ty[len].
+     */
+    struct Packed
+    {
+        static constexpr std::size_t alignment = 1;
+    };
+
+    /**
+     * @brief Layout of a Vec aligned to a number of bytes.
+     *
+     * @tparam bytes The alignment, must be a power of 2.
+     *
+     * @details The size of the vector is rounded up to a multiple of the alignment so
+     *          a Vec<3, float, Aligned16> is padded to 16 bytes and each vector of an
+     *          array starts on its own 16 byte boundary. If the alignment is less than
+     *          the alignment of the type, the type's alignment is used instead.
+     */
+    template<std::size_t bytes> requires (bytes != 0 && (bytes & (bytes - 1)) == 0)
+    struct Aligned
+    {
+        static constexpr std::size_t alignment = bytes;
+    };
+
+    /* Common alignments, 16 is the width of SSE / NEON registers and 32 of AVX registers */
+    using Aligned16 = Aligned<16>;
+    using Aligned32 = Aligned<32>;
+
     /* Excludes the internal namespace from the documentation */
     #ifndef DOXYGEN_HIDE
 
     namespace Internal
     {
+        /*
+         * Each layout of the members is aligned to the strictest of the type and the layout policy.
+         * alignas(Ty) is needed as well as the policy as an alignment weaker than the type is ill-formed.
+         */
+
         /* General layout of a Vec<T> with just an array of x length */
-        template<std::size_t len, typename Ty, typename Enable = void>
-        struct VecMembers
+        template<std::size_t len, typename Ty, typename Layout, typename Enable = void>
+        struct alignas(Ty) alignas(Layout::alignment) VecMembers
         {
             Ty data[len];
 
-            template<typename... Args> VecMembers(Args&&... args) : data{ std::forward<Args>(args)... } {}
+            template<typename... Args> constexpr VecMembers(Args&&... args) : data{ std::forward<Args>(args)... } {}
         };
 
         /* Provides aliases of [X, Y] to indecies of [0, 1] to the array when of length 2 */
-        template<std::size_t len, typename Ty>
-        struct VecMembers<len, Ty, std::enable_if_t<(len == 2)>>
+        template<std::size_t len, typename Ty, typename Layout>
+        struct alignas(Ty) alignas(Layout::alignment) VecMembers<len, Ty, Layout, std::enable_if_t<(len == 2)>>
         {
             union
             {
@@ -37,12 +74,12 @@ namespace PashaBibko::Util
                 Ty data[2];
             };
 
-            template<typename... Args> VecMembers(Args&&... args) : data{ std::forward<Args>(args)... } {}
+            template<typename... Args> constexpr VecMembers(Args&&... args) : data{ std::forward<Args>(args)... } {}
         };
 
         /* Provides aliases of [X, Y, Z] and [R, G, B] to indecies of [0, 1, 2] to the array when of length 3 */
-        template<std::size_t len, typename Ty>
-        struct VecMembers<len, Ty, std::enable_if_t<(len == 3)>>
+        template<std::size_t len, typename Ty, typename Layout>
+        struct alignas(Ty) alignas(Layout::alignment) VecMembers<len, Ty, Layout, std::enable_if_t<(len == 3)>>
         {
             union
             {
@@ -51,12 +88,12 @@ namespace PashaBibko::Util
                 Ty data[3];
             };
 
-            template<typename... Args> VecMembers(Args&&... args) : data{ std::forward<Args>(args)... } {}
+            template<typename... Args> constexpr VecMembers(Args&&... args) : data{ std::forward<Args>(args)... } {}
         };
 
         /* Provides aliases of [X, Y, Z, Z] and [R, G, B, A] to indecies of [0, 1, 2, 3] to the array when of length 4 */
-        template<std::size_t len, typename Ty>
-        struct VecMembers<len, Ty, std::enable_if_t<(len == 4)>>
+        template<std::size_t len, typename Ty, typename Layout>
+        struct alignas(Ty) alignas(Layout::alignment) VecMembers<len, Ty, Layout, std::enable_if_t<(len == 4)>>
         {
             union
             {
@@ -65,7 +102,7 @@ namespace PashaBibko::Util
                 Ty data[4];
             };
 
-            template<typename... Args> VecMembers(Args&&... args) : data{ std::forward<Args>(args)... } {}
+            template<typename... Args> constexpr VecMembers(Args&&... args) : data{ std::forward<Args>(args)... } {}
         };
 
         /* Checks all types within a variadic template are the same */
@@ -91,7 +128,7 @@ namespace PashaBibko::Util
 
         /* The result type when two types are subtracted from each other */
         template<typename LhsTy, typename RhsTy>
-        using SubResultT = decltype(std::declval<LhsTy>() + std::declval<RhsTy>());
+        using SubResultT = decltype(std::declval<LhsTy>() - std::declval<RhsTy>());
 
         /* Checks two types can be multipled together */
         template<typename LhsTy, typename RhsTy>
@@ -108,7 +145,7 @@ namespace PashaBibko::Util
         template<typename LhsTy, typename RhsTy>
         concept CanDiv = requires(LhsTy lhs, RhsTy rhs)
         {
-            { lhs / rhs } -> std::same_as<decltype(lhs + rhs)>;
+            { lhs / rhs } -> std::same_as<decltype(lhs / rhs)>;
         };
 
         /* The result type when two types are divided from each other */
@@ -122,6 +159,10 @@ namespace PashaBibko::Util
             { lhs == rhs } -> std::convertible_to<bool>;
             { lhs != rhs } -> std::convertible_to<bool>;
         };
+
+        /* Checks a type can be used as a scalar with a vector of Ty, stops vectors being treated as scalars */
+        template<typename Scalar, typename Ty>
+        concept IsScalarOf = std::is_arithmetic_v<Scalar> || std::is_same_v<Scalar, Ty>;
     }
 
     #endif // DOXYGEN_HIDE
@@ -131,6 +172,7 @@ namespace PashaBibko::Util
      * 
      * @tparam len The length of the array, cannot be 0 or 1.
      * @tparam Ty The type that the vector contains must be copyable.
+     * @tparam Layout How the vector is aligned in memory, either Packed (default) or Aligned<bytes>.
      * 
      * @details The `Vec` class is a fixed-size, strongly-typed mathematical vector implementation
      *          that supports compile-time size checking and type constraints. It is designed for 
@@ -171,6 +213,20 @@ namespace PashaBibko::Util
      *          for example: Vec2 only has access to x and y as it is only
      *          2 elements long.
      * 
+     *          By default a vector has the same layout as an array of Ty, so a
+     *          Vec3<float> is 12 bytes. An alignment policy can be given as the
+     *          third parameter, such as Vec<4, float, Aligned16>, which aligns
+     *          each vector and pads its size to a multiple of the alignment.
+     *          PaddedVec3<Ty> is a Vec3 aligned to 16 bytes so a Vec3<float>
+     *          takes up 16 bytes and never straddles a cache line. Vectors of
+     *          different layouts can be converted with the explicit constructor
+     *          but cannot be used together in the same operator.
+     * 
+     *          All of the constructors and operators are constexpr so vectors
+     *          can be calculated at compile time. Within a constant expression
+     *          elements must be accessed with operator[] as the letters are
+     *          aliases within a union which cannot be read at compile time.
+     * 
      *          Example usage:
      * @code
      * #include <iostream>
@@ -210,9 +266,9 @@ namespace PashaBibko::Util
      * }
      * @endcode
      */
-    template<std::size_t len, typename Ty>
+    template<std::size_t len, typename Ty, typename Layout = Packed>
         requires (len != 0 && len != 1) && std::is_copy_constructible_v<Ty>
-    struct Vec : public Internal::VecMembers<len, Ty>
+    struct Vec : public Internal::VecMembers<len, Ty, Layout>
     {
         /**
          * @brief Default constructor which default constructs all items.
@@ -221,22 +277,14 @@ namespace PashaBibko::Util
          *          to avoid compile-time errors.
          */
         template<typename = std::enable_if_t<std::is_default_constructible_v<Ty>>>
-        Vec()
-        {
-            for (std::size_t index = 0; index < len; index++)
-                this->data[index] = Ty{};
-        }
+        constexpr Vec() : Internal::VecMembers<len, Ty, Layout>() {}
 
         /**
          * @brief Constructor to create each item in the vector with a given value.
          * 
          * @param value The value that will be copied to all values within the vector.
          */
-        explicit Vec(const Ty& value)
-        {
-            for (std::size_t index = 0; index < len; index++)
-                this->data[index] = value;
-        }
+        explicit constexpr Vec(const Ty& value) : Vec(value, std::make_index_sequence<len>{}) {}
 
         /**
          * @brief Creates a vector with a given value for each item.
@@ -246,8 +294,14 @@ namespace PashaBibko::Util
          * @details Requires all arguments to be the same type as Ty and have the same
          *          length as the array or will have a compile-time error.
          */
-        template<typename... Args> requires Internal::AllSameType<Ty, Args...> && (sizeof...(Args) == len)
-        explicit Vec(Args&&... args) : Internal::VecMembers<len, Ty>(std::forward<Args>(args)...) {}
+        template<typename... Args> requires Internal::AllSameType<Ty, std::remove_cvref_t<Args>...> && (sizeof...(Args) == len)
+        explicit constexpr Vec(Args&&... args) : Internal::VecMembers<len, Ty, Layout>(std::forward<Args>(args)...) {}
+
+        /**
+         * @brief Creates a vector from a vector with a different layout.
+         */
+        template<typename OtherLayout> requires (!std::is_same_v<Layout, OtherLayout>)
+        explicit constexpr Vec(const Vec<len, Ty, OtherLayout>& other) : Vec(other, std::make_index_sequence<len>{}) {}
 
         /**
          * @brief Returns a reference to the item at that index.
@@ -258,7 +312,7 @@ namespace PashaBibko::Util
          *          the bounds of the vector. Accessing elements not
          *          within the bounds is classified as UB.
          */
-        Ty& operator[](std::size_t index) { return this->data[index]; }
+        constexpr Ty& operator[](std::size_t index) { return this->data[index]; }
 
         /**
          * @brief Returns a pointer to the beginning of the array.
@@ -266,7 +320,7 @@ namespace PashaBibko::Util
          * @details Used by C++ to allow the data type to be iterated
          *          over by a range for loop.
          */
-        Ty* begin() noexcept { return this->data; }
+        constexpr Ty* begin() noexcept { return this->data; }
 
         /**
          * @brief Returns a pointer to the end of the vector.
@@ -274,18 +328,18 @@ namespace PashaBibko::Util
          * @details Used by C++ to allow the data type to be iterated
          *          over by a range for loop.
          */
-        Ty* end() { return this->data + len; }
+        constexpr Ty* end() noexcept { return this->data + len; }
 
         /* Hides const versions of functions as they do not need to be documented twice */
         #ifndef DOXYGEN_HIDE
 
-        const Ty& operator[](std::size_t index) const { return this->data[index]; }
+        constexpr const Ty& operator[](std::size_t index) const { return this->data[index]; }
 
-        const Ty* begin() const noexcept { return this->data; }
-        const Ty* cbegin() const noexcept { return this->data; }
+        constexpr const Ty* begin() const noexcept { return this->data; }
+        constexpr const Ty* cbegin() const noexcept { return this->data; }
 
-        const Ty* end() const noexcept { return this->data + len; }
-        const Ty* cend() const noexcept { return this->data + len; }
+        constexpr const Ty* end() const noexcept { return this->data + len; }
+        constexpr const Ty* cend() const noexcept { return this->data + len; }
 
         #endif // DOXYGEN_HIDE
 
@@ -298,8 +352,17 @@ namespace PashaBibko::Util
          */
         template<typename OtherTy>
             requires Internal::CanAdd<Ty, OtherTy> && std::is_same_v<Ty, Internal::AddResultT<Ty, OtherTy>>
-        Vec& operator+= (const Vec<len, OtherTy>& other)
+        constexpr Vec& operator+= (const Vec<len, OtherTy, Layout>& other)
         {
+            if constexpr (std::is_same_v<Ty, OtherTy> && Internal::SimdAdd<len, Ty>)
+            {
+                if (!std::is_constant_evaluated())
+                {
+                    Internal::VecSimd<len, Ty>::Add(this->data, other.data, this->data);
+                    return *this;
+                }
+            }
+
             for (std::size_t index = 0; index < len; index++)
                 this->data[index] += other[index];
 
@@ -315,10 +378,19 @@ namespace PashaBibko::Util
          */
         template<typename OtherTy>
             requires Internal::CanSub<Ty, OtherTy> && std::is_same_v<Ty, Internal::SubResultT<Ty, OtherTy>>
-        Vec& operator-= (const Vec<len, OtherTy>& other)
+        constexpr Vec& operator-= (const Vec<len, OtherTy, Layout>& other)
         {
+            if constexpr (std::is_same_v<Ty, OtherTy> && Internal::SimdSub<len, Ty>)
+            {
+                if (!std::is_constant_evaluated())
+                {
+                    Internal::VecSimd<len, Ty>::Sub(this->data, other.data, this->data);
+                    return *this;
+                }
+            }
+
             for (std::size_t index = 0; index < len; index++)
-                this->data[index] += other[index];
+                this->data[index] -= other[index];
 
             return *this;
         }
@@ -332,10 +404,19 @@ namespace PashaBibko::Util
          */
         template<typename OtherTy>
             requires Internal::CanMul<Ty, OtherTy> && std::is_same_v<Ty, Internal::MulResultT<Ty, OtherTy>>
-        Vec& operator*= (const Vec<len, OtherTy>& other)
+        constexpr Vec& operator*= (const Vec<len, OtherTy, Layout>& other)
         {
+            if constexpr (std::is_same_v<Ty, OtherTy> && Internal::SimdMul<len, Ty>)
+            {
+                if (!std::is_constant_evaluated())
+                {
+                    Internal::VecSimd<len, Ty>::Mul(this->data, other.data, this->data);
+                    return *this;
+                }
+            }
+
             for (std::size_t index = 0; index < len; index++)
-                this->data[index] += other[index];
+                this->data[index] *= other[index];
 
             return *this;
         }
@@ -349,13 +430,135 @@ namespace PashaBibko::Util
          */
         template<typename OtherTy>
             requires Internal::CanDiv<Ty, OtherTy> && std::is_same_v<Ty, Internal::DivResultT<Ty, OtherTy>>
-        Vec& operator/= (const Vec<len, OtherTy>& other)
+        constexpr Vec& operator/= (const Vec<len, OtherTy, Layout>& other)
         {
+            if constexpr (std::is_same_v<Ty, OtherTy> && Internal::SimdDiv<len, Ty>)
+            {
+                if (!std::is_constant_evaluated())
+                {
+                    Internal::VecSimd<len, Ty>::Div(this->data, other.data, this->data);
+                    return *this;
+                }
+            }
+
             for (std::size_t index = 0; index < len; index++)
-                this->data[index] += other[index];
+                this->data[index] /= other[index];
+
+            return *this;
+        }
+
+        /**
+         * @brief Adds a scalar to each element of itself.
+         * 
+         * @details Requires Ty to be able to be added to the scalar,
+         *          otherwise it will not compile and the result type
+         *          to be the same as Ty.
+         */
+        template<typename Scalar>
+            requires Internal::IsScalarOf<Scalar, Ty> && Internal::CanAdd<Ty, Scalar> && std::is_same_v<Ty, Internal::AddResultT<Ty, Scalar>>
+        constexpr Vec& operator+= (const Scalar& scalar)
+        {
+            if constexpr (Internal::SimdAddScalar<len, Ty>)
+            {
+                if (!std::is_constant_evaluated())
+                {
+                    Internal::VecSimd<len, Ty>::AddScalar(this->data, static_cast<Ty>(scalar), this->data);
+                    return *this;
+                }
+            }
+
+            for (std::size_t index = 0; index < len; index++)
+                this->data[index] += scalar;
+
+            return *this;
+        }
+
+        /**
+         * @brief Subtracts a scalar from each element of itself.
+         * 
+         * @details Requires the scalar to be able to be subtracted from Ty,
+         *          otherwise it will not compile and the result type
+         *          to be the same as Ty.
+         */
+        template<typename Scalar>
+            requires Internal::IsScalarOf<Scalar, Ty> && Internal::CanSub<Ty, Scalar> && std::is_same_v<Ty, Internal::SubResultT<Ty, Scalar>>
+        constexpr Vec& operator-= (const Scalar& scalar)
+        {
+            if constexpr (Internal::SimdSubScalar<len, Ty>)
+            {
+                if (!std::is_constant_evaluated())
+                {
+                    Internal::VecSimd<len, Ty>::SubScalar(this->data, static_cast<Ty>(scalar), this->data);
+                    return *this;
+                }
+            }
+
+            for (std::size_t index = 0; index < len; index++)
+                this->data[index] -= scalar;
 
             return *this;
         }
+
+        /**
+         * @brief Multiplies each element of itself by a scalar.
+         * 
+         * @details Requires Ty to be able to be multiplied by the scalar,
+         *          otherwise it will not compile and the result type
+         *          to be the same as Ty.
+         */
+        template<typename Scalar>
+            requires Internal::IsScalarOf<Scalar, Ty> && Internal::CanMul<Ty, Scalar> && std::is_same_v<Ty, Internal::MulResultT<Ty, Scalar>>
+        constexpr Vec& operator*= (const Scalar& scalar)
+        {
+            if constexpr (Internal::SimdMulScalar<len, Ty>)
+            {
+                if (!std::is_constant_evaluated())
+                {
+                    Internal::VecSimd<len, Ty>::MulScalar(this->data, static_cast<Ty>(scalar), this->data);
+                    return *this;
+                }
+            }
+
+            for (std::size_t index = 0; index < len; index++)
+                this->data[index] *= scalar;
+
+            return *this;
+        }
+
+        /**
+         * @brief Divides each element of itself by a scalar.
+         * 
+         * @details Requires Ty to be able to be divided by the scalar,
+         *          otherwise it will not compile and the result type
+         *          to be the same as Ty.
+         */
+        template<typename Scalar>
+            requires Internal::IsScalarOf<Scalar, Ty> && Internal::CanDiv<Ty, Scalar> && std::is_same_v<Ty, Internal::DivResultT<Ty, Scalar>>
+        constexpr Vec& operator/= (const Scalar& scalar)
+        {
+            if constexpr (Internal::SimdDivScalar<len, Ty>)
+            {
+                if (!std::is_constant_evaluated())
+                {
+                    Internal::VecSimd<len, Ty>::DivScalar(this->data, static_cast<Ty>(scalar), this->data);
+                    return *this;
+                }
+            }
+
+            for (std::size_t index = 0; index < len; index++)
+                this->data[index] /= scalar;
+
+            return *this;
+        }
+
+    private:
+        /* Used by the fill constructor to copy the value to each element during initialization */
+        template<std::size_t... index>
+        constexpr Vec(const Ty& value, std::index_sequence<index...>) : Internal::VecMembers<len, Ty, Layout>((static_cast<void>(index), value)...) {}
+
+        /* Used by the layout conversion to copy each element during initialization */
+        template<typename OtherLayout, std::size_t... index>
+        constexpr Vec(const Vec<len, Ty, OtherLayout>& other, std::index_sequence<index...>) : Internal::VecMembers<len, Ty, Layout>(other[index]...) {}
     };
 
     /**
@@ -366,11 +569,21 @@ namespace PashaBibko::Util
      *          also be the same type as when they are normally
      *          added together.
      */
-    template<std::size_t len, typename LhsTy, typename RhsTy, typename ResTy = Internal::AddResultT<LhsTy, RhsTy>>
+    template<std::size_t len, typename LhsTy, typename RhsTy, typename Layout, typename ResTy = Internal::AddResultT<LhsTy, RhsTy>>
         requires Internal::CanAdd<LhsTy, RhsTy>
-    Vec<len, ResTy> operator+ (const Vec<len, LhsTy>& lhs, const Vec<len, RhsTy>& rhs)
+    constexpr Vec<len, ResTy, Layout> operator+ (const Vec<len, LhsTy, Layout>& lhs, const Vec<len, RhsTy, Layout>& rhs)
     {
-        return [&]<std::size_t... index>(std::index_sequence<index...>) { return Vec<len, ResTy>{ (lhs[index] + rhs[index])... }; } (std::make_index_sequence<len>{});
+        if constexpr (std::is_same_v<LhsTy, RhsTy> && std::is_same_v<LhsTy, ResTy> && Internal::SimdAdd<len, ResTy>)
+        {
+            if (!std::is_constant_evaluated())
+            {
+                Vec<len, ResTy, Layout> out;
+                Internal::VecSimd<len, ResTy>::Add(lhs.data, rhs.data, out.data);
+                return out;
+            }
+        }
+
+        return [&]<std::size_t... index>(std::index_sequence<index...>) { return Vec<len, ResTy, Layout>{ (lhs[index] + rhs[index])... }; } (std::make_index_sequence<len>{});
     }
 
     /**
@@ -380,11 +593,21 @@ namespace PashaBibko::Util
      *          be able to be subtracted from each other The result type will
      *          also be the same type as when they are normally subtracted.
      */
-    template<std::size_t len, typename LhsTy, typename RhsTy, typename ResTy = Internal::SubResultT<LhsTy, RhsTy>>
+    template<std::size_t len, typename LhsTy, typename RhsTy, typename Layout, typename ResTy = Internal::SubResultT<LhsTy, RhsTy>>
         requires Internal::CanSub<LhsTy, RhsTy>
-    Vec<len, ResTy> operator- (const Vec<len, LhsTy>& lhs, const Vec<len, RhsTy>& rhs)
+    constexpr Vec<len, ResTy, Layout> operator- (const Vec<len, LhsTy, Layout>& lhs, const Vec<len, RhsTy, Layout>& rhs)
     {
-        return [&]<std::size_t... index>(std::index_sequence<index...>) { return Vec<len, ResTy>{ (lhs[index] - rhs[index])... }; } (std::make_index_sequence<len>{});
+        if constexpr (std::is_same_v<LhsTy, RhsTy> && std::is_same_v<LhsTy, ResTy> && Internal::SimdSub<len, ResTy>)
+        {
+            if (!std::is_constant_evaluated())
+            {
+                Vec<len, ResTy, Layout> out;
+                Internal::VecSimd<len, ResTy>::Sub(lhs.data, rhs.data, out.data);
+                return out;
+            }
+        }
+
+        return [&]<std::size_t... index>(std::index_sequence<index...>) { return Vec<len, ResTy, Layout>{ (lhs[index] - rhs[index])... }; } (std::make_index_sequence<len>{});
     }
 
     /**
@@ -395,11 +618,21 @@ namespace PashaBibko::Util
      *          also be the same type as when they are normally
      *          multiplied together.
      */
-    template<std::size_t len, typename LhsTy, typename RhsTy, typename ResTy = Internal::MulResultT<LhsTy, RhsTy>>
+    template<std::size_t len, typename LhsTy, typename RhsTy, typename Layout, typename ResTy = Internal::MulResultT<LhsTy, RhsTy>>
         requires Internal::CanMul<LhsTy, RhsTy>
-    Vec<len, ResTy> operator* (const Vec<len, LhsTy>& lhs, const Vec<len, RhsTy>& rhs)
+    constexpr Vec<len, ResTy, Layout> operator* (const Vec<len, LhsTy, Layout>& lhs, const Vec<len, RhsTy, Layout>& rhs)
     {
-        return [&]<std::size_t... index>(std::index_sequence<index...>) { return Vec<len, ResTy>{ (lhs[index] * rhs[index])... }; } (std::make_index_sequence<len>{});
+        if constexpr (std::is_same_v<LhsTy, RhsTy> && std::is_same_v<LhsTy, ResTy> && Internal::SimdMul<len, ResTy>)
+        {
+            if (!std::is_constant_evaluated())
+            {
+                Vec<len, ResTy, Layout> out;
+                Internal::VecSimd<len, ResTy>::Mul(lhs.data, rhs.data, out.data);
+                return out;
+            }
+        }
+
+        return [&]<std::size_t... index>(std::index_sequence<index...>) { return Vec<len, ResTy, Layout>{ (lhs[index] * rhs[index])... }; } (std::make_index_sequence<len>{});
     }
 
     /**
@@ -410,11 +643,217 @@ namespace PashaBibko::Util
      *          also be the same type as when they are normally
      *          divided together.
      */
-    template<std::size_t len, typename LhsTy, typename RhsTy, typename ResTy = Internal::SubResultT<LhsTy, RhsTy>>
+    template<std::size_t len, typename LhsTy, typename RhsTy, typename Layout, typename ResTy = Internal::DivResultT<LhsTy, RhsTy>>
         requires Internal::CanDiv<LhsTy, RhsTy>
-    Vec<len, ResTy> operator/ (const Vec<len, LhsTy>& lhs, const Vec<len, RhsTy>& rhs)
+    constexpr Vec<len, ResTy, Layout> operator/ (const Vec<len, LhsTy, Layout>& lhs, const Vec<len, RhsTy, Layout>& rhs)
     {
-        return [&]<std::size_t... index>(std::index_sequence<index...>) { return Vec<len, ResTy>{ (lhs[index] / rhs[index])... }; } (std::make_index_sequence<len>{});
+        if constexpr (std::is_same_v<LhsTy, RhsTy> && std::is_same_v<LhsTy, ResTy> && Internal::SimdDiv<len, ResTy>)
+        {
+            if (!std::is_constant_evaluated())
+            {
+                Vec<len, ResTy, Layout> out;
+                Internal::VecSimd<len, ResTy>::Div(lhs.data, rhs.data, out.data);
+                return out;
+            }
+        }
+
+        return [&]<std::size_t... index>(std::index_sequence<index...>) { return Vec<len, ResTy, Layout>{ (lhs[index] / rhs[index])... }; } (std::make_index_sequence<len>{});
+    }
+
+    /**
+     * @brief Adds a scalar to each element of the vector.
+     * 
+     * @details The scalar must be an arithmetic type or the same type as the vector
+     *          contains. It is used directly instead of being copied into a vector
+     *          first. The result type will be the same type as when they are
+     *          normally added together.
+     */
+    template<std::size_t len, typename LhsTy, typename Layout, typename Scalar, typename ResTy = Internal::AddResultT<LhsTy, Scalar>>
+        requires Internal::IsScalarOf<Scalar, LhsTy> && Internal::CanAdd<LhsTy, Scalar>
+    constexpr Vec<len, ResTy, Layout> operator+ (const Vec<len, LhsTy, Layout>& lhs, const Scalar& rhs)
+    {
+        if constexpr (std::is_same_v<LhsTy, ResTy> && Internal::SimdAddScalar<len, ResTy>)
+        {
+            if (!std::is_constant_evaluated())
+            {
+                Vec<len, ResTy, Layout> out;
+                Internal::VecSimd<len, ResTy>::AddScalar(lhs.data, static_cast<ResTy>(rhs), out.data);
+                return out;
+            }
+        }
+
+        return [&]<std::size_t... index>(std::index_sequence<index...>) { return Vec<len, ResTy, Layout>{ (lhs[index] + rhs)... }; } (std::make_index_sequence<len>{});
+    }
+
+    /**
+     * @brief Adds each element of the vector to a scalar.
+     * 
+     * @details The scalar must be an arithmetic type or the same type as the vector
+     *          contains. The result type will be the same type as when they are
+     *          normally added together.
+     */
+    template<std::size_t len, typename Scalar, typename RhsTy, typename Layout, typename ResTy = Internal::AddResultT<Scalar, RhsTy>>
+        requires Internal::IsScalarOf<Scalar, RhsTy> && Internal::CanAdd<Scalar, RhsTy>
+    constexpr Vec<len, ResTy, Layout> operator+ (const Scalar& lhs, const Vec<len, RhsTy, Layout>& rhs)
+    {
+        if constexpr (std::is_same_v<RhsTy, ResTy> && Internal::SimdAddScalar<len, ResTy>)
+        {
+            if (!std::is_constant_evaluated())
+            {
+                Vec<len, ResTy, Layout> out;
+                Internal::VecSimd<len, ResTy>::AddScalar(rhs.data, static_cast<ResTy>(lhs), out.data);
+                return out;
+            }
+        }
+
+        return [&]<std::size_t... index>(std::index_sequence<index...>) { return Vec<len, ResTy, Layout>{ (lhs + rhs[index])... }; } (std::make_index_sequence<len>{});
+    }
+
+    /**
+     * @brief Subtracts a scalar from each element of the vector.
+     * 
+     * @details The scalar must be an arithmetic type or the same type as the vector
+     *          contains. It is used directly instead of being copied into a vector
+     *          first. The result type will be the same type as when they are
+     *          normally subtracted from each other.
+     */
+    template<std::size_t len, typename LhsTy, typename Layout, typename Scalar, typename ResTy = Internal::SubResultT<LhsTy, Scalar>>
+        requires Internal::IsScalarOf<Scalar, LhsTy> && Internal::CanSub<LhsTy, Scalar>
+    constexpr Vec<len, ResTy, Layout> operator- (const Vec<len, LhsTy, Layout>& lhs, const Scalar& rhs)
+    {
+        if constexpr (std::is_same_v<LhsTy, ResTy> && Internal::SimdSubScalar<len, ResTy>)
+        {
+            if (!std::is_constant_evaluated())
+            {
+                Vec<len, ResTy, Layout> out;
+                Internal::VecSimd<len, ResTy>::SubScalar(lhs.data, static_cast<ResTy>(rhs), out.data);
+                return out;
+            }
+        }
+
+        return [&]<std::size_t... index>(std::index_sequence<index...>) { return Vec<len, ResTy, Layout>{ (lhs[index] - rhs)... }; } (std::make_index_sequence<len>{});
+    }
+
+    /**
+     * @brief Subtracts each element of the vector from a scalar.
+     * 
+     * @details The scalar must be an arithmetic type or the same type as the vector
+     *          contains. The result type will be the same type as when they are
+     *          normally subtracted from each other.
+     */
+    template<std::size_t len, typename Scalar, typename RhsTy, typename Layout, typename ResTy = Internal::SubResultT<Scalar, RhsTy>>
+        requires Internal::IsScalarOf<Scalar, RhsTy> && Internal::CanSub<Scalar, RhsTy>
+    constexpr Vec<len, ResTy, Layout> operator- (const Scalar& lhs, const Vec<len, RhsTy, Layout>& rhs)
+    {
+        if constexpr (std::is_same_v<RhsTy, ResTy> && Internal::SimdScalarSub<len, ResTy>)
+        {
+            if (!std::is_constant_evaluated())
+            {
+                Vec<len, ResTy, Layout> out;
+                Internal::VecSimd<len, ResTy>::ScalarSub(static_cast<ResTy>(lhs), rhs.data, out.data);
+                return out;
+            }
+        }
+
+        return [&]<std::size_t... index>(std::index_sequence<index...>) { return Vec<len, ResTy, Layout>{ (lhs - rhs[index])... }; } (std::make_index_sequence<len>{});
+    }
+
+    /**
+     * @brief Multiplies each element of the vector by a scalar.
+     * 
+     * @details The scalar must be an arithmetic type or the same type as the vector
+     *          contains. It is used directly instead of being copied into a vector
+     *          first. The result type will be the same type as when they are
+     *          normally multiplied together.
+     */
+    template<std::size_t len, typename LhsTy, typename Layout, typename Scalar, typename ResTy = Internal::MulResultT<LhsTy, Scalar>>
+        requires Internal::IsScalarOf<Scalar, LhsTy> && Internal::CanMul<LhsTy, Scalar>
+    constexpr Vec<len, ResTy, Layout> operator* (const Vec<len, LhsTy, Layout>& lhs, const Scalar& rhs)
+    {
+        if constexpr (std::is_same_v<LhsTy, ResTy> && Internal::SimdMulScalar<len, ResTy>)
+        {
+            if (!std::is_constant_evaluated())
+            {
+                Vec<len, ResTy, Layout> out;
+                Internal::VecSimd<len, ResTy>::MulScalar(lhs.data, static_cast<ResTy>(rhs), out.data);
+                return out;
+            }
+        }
+
+        return [&]<std::size_t... index>(std::index_sequence<index...>) { return Vec<len, ResTy, Layout>{ (lhs[index] * rhs)... }; } (std::make_index_sequence<len>{});
+    }
+
+    /**
+     * @brief Multiplies a scalar by each element of the vector.
+     * 
+     * @details The scalar must be an arithmetic type or the same type as the vector
+     *          contains. The result type will be the same type as when they are
+     *          normally multiplied together.
+     */
+    template<std::size_t len, typename Scalar, typename RhsTy, typename Layout, typename ResTy = Internal::MulResultT<Scalar, RhsTy>>
+        requires Internal::IsScalarOf<Scalar, RhsTy> && Internal::CanMul<Scalar, RhsTy>
+    constexpr Vec<len, ResTy, Layout> operator* (const Scalar& lhs, const Vec<len, RhsTy, Layout>& rhs)
+    {
+        if constexpr (std::is_same_v<RhsTy, ResTy> && Internal::SimdMulScalar<len, ResTy>)
+        {
+            if (!std::is_constant_evaluated())
+            {
+                Vec<len, ResTy, Layout> out;
+                Internal::VecSimd<len, ResTy>::MulScalar(rhs.data, static_cast<ResTy>(lhs), out.data);
+                return out;
+            }
+        }
+
+        return [&]<std::size_t... index>(std::index_sequence<index...>) { return Vec<len, ResTy, Layout>{ (lhs * rhs[index])... }; } (std::make_index_sequence<len>{});
+    }
+
+    /**
+     * @brief Divides each element of the vector by a scalar.
+     * 
+     * @details The scalar must be an arithmetic type or the same type as the vector
+     *          contains. It is used directly instead of being copied into a vector
+     *          first. The result type will be the same type as when they are
+     *          normally divided from each other.
+     */
+    template<std::size_t len, typename LhsTy, typename Layout, typename Scalar, typename ResTy = Internal::DivResultT<LhsTy, Scalar>>
+        requires Internal::IsScalarOf<Scalar, LhsTy> && Internal::CanDiv<LhsTy, Scalar>
+    constexpr Vec<len, ResTy, Layout> operator/ (const Vec<len, LhsTy, Layout>& lhs, const Scalar& rhs)
+    {
+        if constexpr (std::is_same_v<LhsTy, ResTy> && Internal::SimdDivScalar<len, ResTy>)
+        {
+            if (!std::is_constant_evaluated())
+            {
+                Vec<len, ResTy, Layout> out;
+                Internal::VecSimd<len, ResTy>::DivScalar(lhs.data, static_cast<ResTy>(rhs), out.data);
+                return out;
+            }
+        }
+
+        return [&]<std::size_t... index>(std::index_sequence<index...>) { return Vec<len, ResTy, Layout>{ (lhs[index] / rhs)... }; } (std::make_index_sequence<len>{});
+    }
+
+    /**
+     * @brief Divides a scalar by each element of the vector.
+     * 
+     * @details The scalar must be an arithmetic type or the same type as the vector
+     *          contains. The result type will be the same type as when they are
+     *          normally divided from each other.
+     */
+    template<std::size_t len, typename Scalar, typename RhsTy, typename Layout, typename ResTy = Internal::DivResultT<Scalar, RhsTy>>
+        requires Internal::IsScalarOf<Scalar, RhsTy> && Internal::CanDiv<Scalar, RhsTy>
+    constexpr Vec<len, ResTy, Layout> operator/ (const Scalar& lhs, const Vec<len, RhsTy, Layout>& rhs)
+    {
+        if constexpr (std::is_same_v<RhsTy, ResTy> && Internal::SimdScalarDiv<len, ResTy>)
+        {
+            if (!std::is_constant_evaluated())
+            {
+                Vec<len, ResTy, Layout> out;
+                Internal::VecSimd<len, ResTy>::ScalarDiv(static_cast<ResTy>(lhs), rhs.data, out.data);
+                return out;
+            }
+        }
+
+        return [&]<std::size_t... index>(std::index_sequence<index...>) { return Vec<len, ResTy, Layout>{ (lhs / rhs[index])... }; } (std::make_index_sequence<len>{});
     }
 
     /**
@@ -423,10 +862,16 @@ namespace PashaBibko::Util
      * @details Requires both the == and != operators to
      *          be available for both types.
      */
-    template<std::size_t len, typename LhsTy, typename RhsTy>
+    template<std::size_t len, typename LhsTy, typename RhsTy, typename Layout>
         requires Internal::CanEqualityCheck<LhsTy, RhsTy>
-    bool operator== (const Vec<len, LhsTy>& lhs, const Vec<len, RhsTy>& rhs)
+    constexpr bool operator== (const Vec<len, LhsTy, Layout>& lhs, const Vec<len, RhsTy, Layout>& rhs)
     {
+        if constexpr (std::is_same_v<LhsTy, RhsTy> && Internal::SimdEqual<len, LhsTy>)
+        {
+            if (!std::is_constant_evaluated())
+                return Internal::VecSimd<len, LhsTy>::Equal(lhs.data, rhs.data);
+        }
+
         for (std::size_t index = 0; index < len; index++)
         {
             if (lhs[index] != rhs[index])
@@ -442,17 +887,11 @@ namespace PashaBibko::Util
      * @details Requires both the == and != operators to
      *          be available for both types.
      */
-    template<std::size_t len, typename LhsTy, typename RhsTy>
+    template<std::size_t len, typename LhsTy, typename RhsTy, typename Layout>
         requires Internal::CanEqualityCheck<LhsTy, RhsTy>
-    bool operator!= (const Vec<len, LhsTy>& lhs, const Vec<len, RhsTy>& rhs)
+    constexpr bool operator!= (const Vec<len, LhsTy, Layout>& lhs, const Vec<len, RhsTy, Layout>& rhs)
     {
-        for (size_t index = 0; index < len; index++)
-        {
-            if (lhs[index] == rhs[index])
-                return false;
-        }
-
-        return true;
+        return !(lhs == rhs);
     }
 
     /* Hides using aliases to avoid uneccesary bloat in doxygen documentation */
@@ -468,11 +907,11 @@ namespace PashaBibko::Util
     template<typename Ty = float>
     using Vec4 = Vec<4, Ty>;
 
-    using Vec2s = Vec3<short>;
-    using Vec2i = Vec3<int>;
-    using Vec2u = Vec3<unsigned int>;
-    using Vec2l = Vec3<long>;
-    using Vec2d = Vec3<double>;
+    using Vec2s = Vec2<short>;
+    using Vec2i = Vec2<int>;
+    using Vec2u = Vec2<unsigned int>;
+    using Vec2l = Vec2<long>;
+    using Vec2d = Vec2<double>;
 
     using Vec3s = Vec3<short>;
     using Vec3i = Vec3<int>;
@@ -480,11 +919,40 @@ namespace PashaBibko::Util
     using Vec3l = Vec3<long>;
     using Vec3d = Vec3<double>;
 
-    using Vec3s = Vec3<short>;
-    using Vec3i = Vec3<int>;
-    using Vec3u = Vec3<unsigned int>;
-    using Vec3l = Vec3<long>;
-    using Vec3d = Vec3<double>;
+    using Vec4s = Vec4<short>;
+    using Vec4i = Vec4<int>;
+    using Vec4u = Vec4<unsigned int>;
+    using Vec4l = Vec4<long>;
+    using Vec4d = Vec4<double>;
+
+    template<typename Ty = float>
+    using PaddedVec3 = Vec<3, Ty, Aligned16>;
+
+    #endif // DOXYGEN_HIDE
+
+    /* Excludes the internal namespace from the documentation */
+    #ifndef DOXYGEN_HIDE
+
+    namespace Internal
+    {
+        /* The default layout is the same as an array so vectors can be copied to and from buffers of Ty */
+        static_assert(sizeof(Vec<3, float>) == sizeof(float[3]) && alignof(Vec<3, float>) == alignof(float));
+        static_assert(sizeof(Vec<4, float>) == sizeof(float[4]) && alignof(Vec<4, float>) == alignof(float));
+        static_assert(sizeof(Vec<2, double>) == sizeof(double[2]) && alignof(Vec<2, double>) == alignof(double));
+
+        /* Aligned vectors can be loaded by aligned SIMD instructions, a padded Vec3 fills a whole register */
+        static_assert(sizeof(PaddedVec3<float>) == 16 && alignof(PaddedVec3<float>) == 16);
+        static_assert(sizeof(PaddedVec3<float>[4]) == 64);
+        static_assert(sizeof(Vec<4, float, Aligned16>) == 16 && alignof(Vec<4, float, Aligned16>) == 16);
+        static_assert(sizeof(Vec<4, double, Aligned32>) == 32 && alignof(Vec<4, double, Aligned32>) == 32);
+
+        /* An alignment weaker than the type uses the alignment of the type */
+        static_assert(alignof(Vec<2, double, Aligned<4>>) == alignof(double));
+
+        /* Vectors can be copied as raw bytes, such as when uploading a buffer of them */
+        static_assert(std::is_trivially_copyable_v<Vec<3, float>> && std::is_standard_layout_v<Vec<3, float>>);
+        static_assert(std::is_trivially_copyable_v<PaddedVec3<float>> && std::is_standard_layout_v<PaddedVec3<float>>);
+    }
 
     #endif // DOXYGEN_HIDE
 }
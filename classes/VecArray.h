@@ -0,0 +1,564 @@
+#pragma once
+
+#include <classes/Vec.h>
+
+#include <type_traits>
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <utility>
+#include <limits>
+#include <memory>
+#include <cmath>
+#include <span>
+#include <new>
+
+/**
+ * @file VecArray.h
+ *
+ * @brief Contains the defenition of VecArray<len, Ty>, a container of vectors
+ *        that stores each component in its own array.
+ */
+
+namespace PashaBibko::Util
+{
+    /* Excludes the internal namespace from the documentation */
+    #ifndef DOXYGEN_HIDE
+
+    namespace Internal
+    {
+        /* Each component array starts on its own cache line */
+        static constexpr std::size_t VecArrayAlignment = 64;
+
+        struct VecArrayDeleter
+        {
+            void operator()(void* ptr) const { ::operator delete(ptr, std::align_val_t{ VecArrayAlignment }); }
+        };
+
+        /*
+         * Element-wise operations over whole arrays. They use the 4 lane SIMD kernel of Vec<4, Ty>
+         * if there is one, treating each 4 elements of the array as a vector, and finish the last
+         * few elements with a scalar loop.
+         */
+
+        template<typename Ty>
+        inline void ArrayAdd(Ty* dst, const Ty* src, std::size_t count)
+        {
+            std::size_t index = 0;
+            if constexpr (SimdAdd<4, Ty>)
+            {
+                for (; index + 4 <= count; index += 4)
+                    VecSimd<4, Ty>::Add(dst + index, src + index, dst + index);
+            }
+
+            for (; index < count; index++)
+                dst[index] += src[index];
+        }
+
+        template<typename Ty>
+        inline void ArraySub(Ty* dst, const Ty* src, std::size_t count)
+        {
+            std::size_t index = 0;
+            if constexpr (SimdSub<4, Ty>)
+            {
+                for (; index + 4 <= count; index += 4)
+                    VecSimd<4, Ty>::Sub(dst + index, src + index, dst + index);
+            }
+
+            for (; index < count; index++)
+                dst[index] -= src[index];
+        }
+
+        template<typename Ty>
+        inline void ArrayScale(Ty* dst, Ty factor, std::size_t count)
+        {
+            std::size_t index = 0;
+            if constexpr (SimdMulScalar<4, Ty>)
+            {
+                for (; index + 4 <= count; index += 4)
+                    VecSimd<4, Ty>::MulScalar(dst + index, factor, dst + index);
+            }
+
+            for (; index < count; index++)
+                dst[index] *= factor;
+        }
+
+        /*
+         * Reductions over a whole array. Each 4 elements are combined into 4 running values with
+         * the SIMD kernel, which are reduced to one at the end, and the last few are done with a
+         * scalar loop. The array is passed as the first argument of the kernel so unordered
+         * elements (such as NaN) are skipped like the scalar loop, apart from on ARM64.
+         */
+
+        template<typename Ty>
+        inline Ty ArrayMin(const Ty* src, std::size_t count)
+        {
+            Ty result = std::numeric_limits<Ty>::max();
+            std::size_t index = 0;
+
+            if constexpr (SimdMin<4, Ty> && SimdMinElement<4, Ty>)
+            {
+                Ty lowest[4] = { result, result, result, result };
+                for (; index + 4 <= count; index += 4)
+                    VecSimd<4, Ty>::Min(src + index, lowest, lowest);
+
+                result = VecSimd<4, Ty>::MinElement(lowest);
+            }
+
+            for (; index < count; index++)
+                result = std::min(result, src[index]);
+
+            return result;
+        }
+
+        template<typename Ty>
+        inline Ty ArrayMax(const Ty* src, std::size_t count)
+        {
+            Ty result = std::numeric_limits<Ty>::lowest();
+            std::size_t index = 0;
+
+            if constexpr (SimdMax<4, Ty> && SimdMaxElement<4, Ty>)
+            {
+                Ty highest[4] = { result, result, result, result };
+                for (; index + 4 <= count; index += 4)
+                    VecSimd<4, Ty>::Max(src + index, highest, highest);
+
+                result = VecSimd<4, Ty>::MaxElement(highest);
+            }
+
+            for (; index < count; index++)
+                result = std::max(result, src[index]);
+
+            return result;
+        }
+
+        /* out[index] = sum of lhs[component][index] * rhs[component][index] */
+        template<std::size_t len, typename Ty>
+        inline void ArrayDot(const Ty* const* lhs, const Ty* const* rhs, Ty* out, std::size_t count)
+        {
+            std::size_t index = 0;
+            if constexpr (SimdMul<4, Ty> && SimdAdd<4, Ty>)
+            {
+                for (; index + 4 <= count; index += 4)
+                {
+                    Ty sum[4];
+                    VecSimd<4, Ty>::Mul(lhs[0] + index, rhs[0] + index, sum);
+
+                    for (std::size_t component = 1; component < len; component++)
+                    {
+                        Ty product[4];
+                        VecSimd<4, Ty>::Mul(lhs[component] + index, rhs[component] + index, product);
+                        VecSimd<4, Ty>::Add(sum, product, sum);
+                    }
+
+                    std::memcpy(out + index, sum, sizeof(sum));
+                }
+            }
+
+            for (; index < count; index++)
+            {
+                Ty sum = lhs[0][index] * rhs[0][index];
+                for (std::size_t component = 1; component < len; component++)
+                    sum += lhs[component][index] * rhs[component][index];
+
+                out[index] = sum;
+            }
+        }
+    }
+
+    #endif // DOXYGEN_HIDE
+
+    /**
+     * @brief Container of vectors stored as a structure of arrays.
+     *
+     * @tparam len The length of each vector.
+     * @tparam Ty The type of each component, must be an arithmetic type.
+     *
+     * @details std::vector<Vec3<float>> stores [x, y, z, x, y, z, ...] which means a SIMD
+     *          register loaded from it contains a mix of components. VecArray instead stores
+     *          [x, x, x, ...] [y, y, y, ...] [z, z, z, ...] with each array aligned to a cache
+     *          line, so the bulk operations work on 4 vectors at a time (using the same kernels
+     *          as Vec<4, Ty>) and only read the memory they need.
+     *
+     *          Individual vectors can still be read and written with operator[] which returns
+     *          a proxy that converts to and from Vec<len, Ty>. Copying to and from an array of
+     *          Vec<len, Ty> is done with the span constructor and CopyTo().
+     *
+     * @code
+     * Util::VecArray<3, float> positions(particles);   // std::span<const Util::Vec3<float>>
+     * Util::VecArray<3, float> velocities(particles.size());
+     *
+     * velocities.Scale(deltaTime);
+     * positions.Add(velocities);
+     *
+     * Util::Vec3<float> lowest = positions.Min();
+     * positions[0] = Util::Vec3<float>(0.0f, 0.0f, 0.0f);
+     *
+     * positions.CopyTo(particles);
+     * @endcode
+     */
+    template<std::size_t len, typename Ty>
+        requires (len != 0 && len != 1) && std::is_arithmetic_v<Ty>
+    class VecArray final
+    {
+        public:
+            /**
+             * @brief Proxy to a single vector within the array.
+             *
+             * @details Reads and writes to the components within the array,
+             *          it is only valid whilst the array is not resized.
+             */
+            class Reference final
+            {
+                public:
+                    /* Gathers the components into a vector */
+                    Vec<len, Ty> Get() const
+                    {
+                        Vec<len, Ty> out;
+                        for (std::size_t component = 0; component < len; component++)
+                            out[component] = (*this)[component];
+
+                        return out;
+                    }
+
+                    operator Vec<len, Ty>() const { return Get(); }
+
+                    /* The Vec operators are templates so will not convert the proxy by themselves */
+                    friend bool operator== (const Reference& lhs, const Vec<len, Ty>& rhs) { return lhs.Get() == rhs; }
+                    friend bool operator!= (const Reference& lhs, const Vec<len, Ty>& rhs) { return lhs.Get() != rhs; }
+
+                    /* Scatters the vector into the component arrays */
+                    Reference& operator= (const Vec<len, Ty>& vec)
+                    {
+                        for (std::size_t component = 0; component < len; component++)
+                            (*this)[component] = vec[component];
+
+                        return *this;
+                    }
+
+                    Reference& operator= (const Reference& other) { return *this = other.Get(); }
+
+                    Reference& operator+= (const Vec<len, Ty>& vec) { return *this = Get() + vec; }
+                    Reference& operator-= (const Vec<len, Ty>& vec) { return *this = Get() - vec; }
+                    Reference& operator*= (const Vec<len, Ty>& vec) { return *this = Get() * vec; }
+                    Reference& operator/= (const Vec<len, Ty>& vec) { return *this = Get() / vec; }
+
+                    /* Returns the component of the vector, 0 = x, 1 = y... */
+                    Ty& operator[](std::size_t component) const { return m_Array->m_Data[component * m_Array->m_Capacity + m_Index]; }
+
+                private:
+                    Reference(VecArray* array, std::size_t index)
+                        : m_Array(array), m_Index(index)
+                    {}
+
+                    friend class VecArray;
+
+                    VecArray* m_Array;
+                    std::size_t m_Index;
+            };
+
+            /**
+             * @brief Creates an empty array.
+             */
+            VecArray() = default;
+
+            /**
+             * @brief Creates an array of a given size with all components set to 0.
+             */
+            explicit VecArray(std::size_t size)
+            {
+                Resize(size);
+            }
+
+            /**
+             * @brief Creates the array by copying an array of vectors.
+             */
+            explicit VecArray(std::span<const Vec<len, Ty>> vecs)
+            {
+                Reserve(vecs.size());
+                m_Size = vecs.size();
+
+                for (std::size_t index = 0; index < m_Size; index++)
+                {
+                    for (std::size_t component = 0; component < len; component++)
+                        ComponentData(component)[index] = vecs[index][component];
+                }
+            }
+
+            VecArray(const VecArray& other)
+            {
+                Reserve(other.m_Size);
+                m_Size = other.m_Size;
+
+                for (std::size_t component = 0; m_Size != 0 && component < len; component++)
+                    std::memcpy(ComponentData(component), other.ComponentData(component), m_Size * sizeof(Ty));
+            }
+
+            VecArray& operator= (const VecArray& other)
+            {
+                if (this != &other)
+                {
+                    VecArray copy(other);
+                    *this = std::move(copy);
+                }
+
+                return *this;
+            }
+
+            VecArray(VecArray&& other) noexcept
+                : m_Data(std::move(other.m_Data)), m_Size(other.m_Size), m_Capacity(other.m_Capacity)
+            {
+                other.m_Size = 0;
+                other.m_Capacity = 0;
+            }
+
+            VecArray& operator= (VecArray&& other) noexcept
+            {
+                m_Data = std::move(other.m_Data);
+                m_Size = std::exchange(other.m_Size, 0);
+                m_Capacity = std::exchange(other.m_Capacity, 0);
+
+                return *this;
+            }
+
+            /**
+             * @brief Returns a proxy to the vector at the index.
+             *
+             * @warning The function does not check if the index is within
+             *          the bounds of the array. Accessing elements not
+             *          within the bounds is classified as UB.
+             */
+            Reference operator[](std::size_t index) { return Reference(this, index); }
+
+            /**
+             * @brief Returns a copy of the vector at the index.
+             */
+            Vec<len, Ty> operator[](std::size_t index) const
+            {
+                Vec<len, Ty> out;
+                for (std::size_t component = 0; component < len; component++)
+                    out[component] = ComponentData(component)[index];
+
+                return out;
+            }
+
+            /**
+             * @brief Returns the contiguous array of a single component, 0 = x, 1 = y...
+             *
+             * @details The start of the array is aligned to 64 bytes.
+             */
+            std::span<Ty> Component(std::size_t component) { return { ComponentData(component), m_Size }; }
+
+            /* Hides const versions of functions as they do not need to be documented twice */
+            #ifndef DOXYGEN_HIDE
+
+            std::span<const Ty> Component(std::size_t component) const { return { ComponentData(component), m_Size }; }
+
+            #endif // DOXYGEN_HIDE
+
+            /**
+             * @brief Returns the amount of vectors in the array.
+             */
+            std::size_t Size() const { return m_Size; }
+
+            /**
+             * @brief Returns the amount of vectors the array can hold before it reallocates.
+             */
+            std::size_t Capacity() const { return m_Capacity; }
+
+            /**
+             * @brief Makes sure the array can hold at least that many vectors without reallocating.
+             */
+            void Reserve(std::size_t capacity)
+            {
+                if (capacity <= m_Capacity)
+                    return;
+
+                /* Rounds up so each component array starts on a new cache line */
+                constexpr std::size_t perLine = std::max<std::size_t>(Internal::VecArrayAlignment / sizeof(Ty), 1);
+                capacity = (capacity + perLine - 1) / perLine * perLine;
+
+                const std::size_t bytes = capacity * len * sizeof(Ty);
+                std::unique_ptr<Ty[], Internal::VecArrayDeleter> data(static_cast<Ty*>(::operator new(bytes, std::align_val_t{ Internal::VecArrayAlignment })));
+                std::memset(data.get(), 0, bytes);
+
+                for (std::size_t component = 0; m_Size != 0 && component < len; component++)
+                    std::memcpy(data.get() + component * capacity, ComponentData(component), m_Size * sizeof(Ty));
+
+                m_Data = std::move(data);
+                m_Capacity = capacity;
+            }
+
+            /**
+             * @brief Changes the amount of vectors in the array, new vectors have all components set to 0.
+             */
+            void Resize(std::size_t size)
+            {
+                Reserve(size);
+
+                /* Clears vectors that were removed by a previous resize so the new ones are 0 */
+                for (std::size_t component = 0; size > m_Size && component < len; component++)
+                    std::fill(ComponentData(component) + m_Size, ComponentData(component) + size, Ty{});
+
+                m_Size = size;
+            }
+
+            /**
+             * @brief Adds a vector to the end of the array.
+             */
+            void PushBack(const Vec<len, Ty>& vec)
+            {
+                if (m_Size == m_Capacity)
+                    Reserve(std::max<std::size_t>(m_Capacity * 2, 16));
+
+                (*this)[m_Size++] = vec;
+            }
+
+            /**
+             * @brief Removes all vectors from the array without freeing the memory.
+             */
+            void Clear() { m_Size = 0; }
+
+            /**
+             * @brief Copies the vectors into an array of Vec<len, Ty>.
+             *
+             * @details Copies up to the smaller of the two sizes.
+             */
+            void CopyTo(std::span<Vec<len, Ty>> out) const
+            {
+                const std::size_t count = std::min(out.size(), m_Size);
+                for (std::size_t index = 0; index < count; index++)
+                {
+                    for (std::size_t component = 0; component < len; component++)
+                        out[index][component] = ComponentData(component)[index];
+                }
+            }
+
+            /**
+             * @brief Adds each vector of the other array to the vector at the same index.
+             *
+             * @warning Both arrays must be the same size.
+             */
+            void Add(const VecArray& other)
+            {
+                for (std::size_t component = 0; component < len; component++)
+                    Internal::ArrayAdd(ComponentData(component), other.ComponentData(component), m_Size);
+            }
+
+            /**
+             * @brief Subtracts each vector of the other array from the vector at the same index.
+             *
+             * @warning Both arrays must be the same size.
+             */
+            void Sub(const VecArray& other)
+            {
+                for (std::size_t component = 0; component < len; component++)
+                    Internal::ArraySub(ComponentData(component), other.ComponentData(component), m_Size);
+            }
+
+            /**
+             * @brief Multiplies every vector by the same value.
+             */
+            void Scale(Ty factor)
+            {
+                for (std::size_t component = 0; component < len; component++)
+                    Internal::ArrayScale(ComponentData(component), factor, m_Size);
+            }
+
+            /**
+             * @brief Writes the dot product of each pair of vectors to the output.
+             *
+             * @warning Both arrays and the output must be the same size.
+             */
+            void Dot(const VecArray& other, std::span<Ty> out) const
+            {
+                const Ty* lhs[len];
+                const Ty* rhs[len];
+
+                for (std::size_t component = 0; component < len; component++)
+                {
+                    lhs[component] = ComponentData(component);
+                    rhs[component] = other.ComponentData(component);
+                }
+
+                Internal::ArrayDot<len>(lhs, rhs, out.data(), m_Size);
+            }
+
+            /**
+             * @brief Scales every vector to have a length of 1.
+             *
+             * @details Only available for arrays of floating point types.
+             *
+             * @warning A vector with a length of 0 has no direction,
+             *          normalizing it will set it to NaN.
+             */
+            void Normalize() requires std::is_floating_point_v<Ty>
+            {
+                /* Works in blocks so the lengths fit in a small buffer on the stack */
+                constexpr std::size_t blockSize = 256;
+                Ty lengths[blockSize];
+
+                const Ty* components[len];
+                for (std::size_t component = 0; component < len; component++)
+                    components[component] = ComponentData(component);
+
+                for (std::size_t start = 0; start < m_Size; start += blockSize)
+                {
+                    const std::size_t count = std::min(blockSize, m_Size - start);
+
+                    const Ty* block[len];
+                    for (std::size_t component = 0; component < len; component++)
+                        block[component] = components[component] + start;
+
+                    Internal::ArrayDot<len>(block, block, lengths, count);
+
+                    /* Stores the reciprocal so each component is a multiplication instead of a division */
+                    for (std::size_t index = 0; index < count; index++)
+                        lengths[index] = Ty(1) / std::sqrt(lengths[index]);
+
+                    for (std::size_t component = 0; component < len; component++)
+                    {
+                        Ty* data = ComponentData(component) + start;
+                        for (std::size_t index = 0; index < count; index++)
+                            data[index] *= lengths[index];
+                    }
+                }
+            }
+
+            /**
+             * @brief Returns the smallest value of each component across all vectors.
+             *
+             * @details An empty array returns the largest value of Ty for each component.
+             */
+            Vec<len, Ty> Min() const
+            {
+                Vec<len, Ty> out;
+                for (std::size_t component = 0; component < len; component++)
+                    out[component] = Internal::ArrayMin(ComponentData(component), m_Size);
+
+                return out;
+            }
+
+            /**
+             * @brief Returns the largest value of each component across all vectors.
+             *
+             * @details An empty array returns the lowest value of Ty for each component.
+             */
+            Vec<len, Ty> Max() const
+            {
+                Vec<len, Ty> out;
+                for (std::size_t component = 0; component < len; component++)
+                    out[component] = Internal::ArrayMax(ComponentData(component), m_Size);
+
+                return out;
+            }
+
+        private:
+            Ty* ComponentData(std::size_t component) { return m_Data.get() + component * m_Capacity; }
+            const Ty* ComponentData(std::size_t component) const { return m_Data.get() + component * m_Capacity; }
+
+            std::unique_ptr<Ty[], Internal::VecArrayDeleter> m_Data;
+            std::size_t m_Size = 0;
+            std::size_t m_Capacity = 0;
+    };
+}
@@ -0,0 +1,261 @@
+#pragma once
+
+#include <classes/Vec.h>
+
+#include <type_traits>
+#include <utility>
+#include <cstddef>
+
+/**
+ * @file VecExpr.h
+ *
+ * @brief Contains the opt-in lazy arithmetic for Vec<len, Ty> which evaluates
+ *        a whole expression in a single pass without creating temporaries.
+ */
+
+namespace PashaBibko::Util
+{
+    /* Excludes the internal namespace from the documentation */
+    #ifndef DOXYGEN_HIDE
+
+    namespace Internal
+    {
+        /*
+         * Base of every node in a lazy expression. Derived types provide operator[] which
+         * calculates a single element of the result, the base provides the evaluation of
+         * the whole expression into a Vec.
+         */
+        template<typename Derived, std::size_t len, typename Ty>
+        struct VecExpr
+        {
+            static constexpr std::size_t length = len;
+            using ValueType = Ty;
+
+            template<typename Layout = Packed>
+            constexpr Vec<len, Ty, Layout> Eval() const
+            {
+                const Derived& self = static_cast<const Derived&>(*this);
+                return [&]<std::size_t... index>(std::index_sequence<index...>) { return Vec<len, Ty, Layout>{ self[index]... }; } (std::make_index_sequence<len>{});
+            }
+
+            template<typename Layout>
+            constexpr operator Vec<len, Ty, Layout>() const { return Eval<Layout>(); }
+        };
+
+        /* Checks if a type is a node of a lazy expression */
+        template<typename Ty>
+        concept IsVecExpr = requires
+        {
+            { Ty::length } -> std::convertible_to<std::size_t>;
+            typename Ty::ValueType;
+        } && std::is_base_of_v<VecExpr<Ty, Ty::length, typename Ty::ValueType>, Ty>;
+
+        /* Leaf of an expression which refers to an existing vector */
+        template<std::size_t len, typename Ty, typename Layout>
+        struct VecRefExpr : VecExpr<VecRefExpr<len, Ty, Layout>, len, Ty>
+        {
+            explicit constexpr VecRefExpr(const Vec<len, Ty, Layout>& vec) : vec(vec) {}
+
+            constexpr const Ty& operator[](std::size_t index) const { return vec[index]; }
+
+            const Vec<len, Ty, Layout>& vec;
+        };
+
+        /* Vectors used directly in a lazy expression are wrapped in a leaf, nodes are used as they are */
+        template<typename Ty>
+        struct LazyOperand
+        {
+            using Type = Ty;
+            static constexpr const Ty& Wrap(const Ty& expr) { return expr; }
+        };
+
+        template<std::size_t len, typename Ty, typename Layout>
+        struct LazyOperand<Vec<len, Ty, Layout>>
+        {
+            using Type = VecRefExpr<len, Ty, Layout>;
+            static constexpr Type Wrap(const Vec<len, Ty, Layout>& vec) { return Type(vec); }
+        };
+
+        template<typename Ty>
+        using LazyOperandT = typename LazyOperand<Ty>::Type;
+
+        /* Checks two operands can be combined into an expression, at least one must already be lazy */
+        template<typename LhsTy, typename RhsTy>
+        concept LazyOperands = (IsVecExpr<LhsTy> || IsVecExpr<RhsTy>) &&
+            IsVecExpr<LazyOperandT<LhsTy>> && IsVecExpr<LazyOperandT<RhsTy>> &&
+            (LazyOperandT<LhsTy>::length == LazyOperandT<RhsTy>::length);
+
+        template<typename Ty>
+        using LazyValueT = typename LazyOperandT<Ty>::ValueType;
+
+        /* Each operator of the expression, ResultT matches the result type of the eager operators */
+
+        struct VecAddOp
+        {
+            template<typename LhsTy, typename RhsTy> using ResultT = AddResultT<LhsTy, RhsTy>;
+            template<typename LhsTy, typename RhsTy> static constexpr auto Apply(const LhsTy& lhs, const RhsTy& rhs) { return lhs + rhs; }
+        };
+
+        struct VecSubOp
+        {
+            template<typename LhsTy, typename RhsTy> using ResultT = SubResultT<LhsTy, RhsTy>;
+            template<typename LhsTy, typename RhsTy> static constexpr auto Apply(const LhsTy& lhs, const RhsTy& rhs) { return lhs - rhs; }
+        };
+
+        struct VecMulOp
+        {
+            template<typename LhsTy, typename RhsTy> using ResultT = MulResultT<LhsTy, RhsTy>;
+            template<typename LhsTy, typename RhsTy> static constexpr auto Apply(const LhsTy& lhs, const RhsTy& rhs) { return lhs * rhs; }
+        };
+
+        struct VecDivOp
+        {
+            template<typename LhsTy, typename RhsTy> using ResultT = DivResultT<LhsTy, RhsTy>;
+            template<typename LhsTy, typename RhsTy> static constexpr auto Apply(const LhsTy& lhs, const RhsTy& rhs) { return lhs / rhs; }
+        };
+
+        /* Node that applies an operator to each element of two sub-expressions */
+        template<typename LhsExpr, typename RhsExpr, typename Op>
+        struct VecBinaryExpr : VecExpr<VecBinaryExpr<LhsExpr, RhsExpr, Op>, LhsExpr::length,
+            typename Op::template ResultT<typename LhsExpr::ValueType, typename RhsExpr::ValueType>>
+        {
+            using ValueType = typename Op::template ResultT<typename LhsExpr::ValueType, typename RhsExpr::ValueType>;
+
+            constexpr VecBinaryExpr(const LhsExpr& lhs, const RhsExpr& rhs) : lhs(lhs), rhs(rhs) {}
+
+            constexpr ValueType operator[](std::size_t index) const { return static_cast<ValueType>(Op::Apply(lhs[index], rhs[index])); }
+
+            /* Sub-expressions are stored by value, they only hold references to the vectors */
+            LhsExpr lhs;
+            RhsExpr rhs;
+        };
+
+        template<typename Op, typename LhsTy, typename RhsTy>
+        constexpr auto MakeBinaryExpr(const LhsTy& lhs, const RhsTy& rhs)
+        {
+            return VecBinaryExpr<LazyOperandT<LhsTy>, LazyOperandT<RhsTy>, Op>(LazyOperand<LhsTy>::Wrap(lhs), LazyOperand<RhsTy>::Wrap(rhs));
+        }
+    }
+
+    #endif // DOXYGEN_HIDE
+
+    /**
+     * @brief Starts a lazy expression from a vector.
+     *
+     * @details The normal operators of Vec return a new vector for every operation, so
+     *          `a + b * c - d` creates two temporary vectors before the result. An operator
+     *          with a lazy operand, either a vector wrapped with Lazy() or another expression,
+     *          instead builds an expression which calculates each element of the result in
+     *          one pass when it is assigned to a Vec, or when Eval() is called.
+     *
+     *          Only operators with a lazy operand are deferred, the normal operators follow
+     *          C++ precedence as usual. In `Util::Lazy(a) + b * c` the `b * c` is evaluated
+     *          straight away into a temporary vector, so every operand of a multiplication
+     *          or division that should be deferred has to be lazy itself.
+     *
+     *          The result types are the same as the normal operators and an expression
+     *          can only be built if the normal operators would allow it.
+     *
+     * @code
+     * Util::Vec4<float> result = Util::Lazy(a) + Util::Lazy(b) * c - d;
+     * result += Util::Lazy(b) * c;
+     * @endcode
+     *
+     * @warning The expression refers to the vectors it was built from, it must be
+     *          evaluated before they are destroyed. Do not store it with auto.
+     */
+    template<std::size_t len, typename Ty, typename Layout>
+    constexpr Internal::VecRefExpr<len, Ty, Layout> Lazy(const Vec<len, Ty, Layout>& vec)
+    {
+        return Internal::VecRefExpr<len, Ty, Layout>(vec);
+    }
+
+    /**
+     * @brief Adds two operands of a lazy expression together.
+     */
+    template<typename LhsTy, typename RhsTy>
+        requires Internal::LazyOperands<LhsTy, RhsTy> && Internal::CanAdd<Internal::LazyValueT<LhsTy>, Internal::LazyValueT<RhsTy>>
+    constexpr auto operator+ (const LhsTy& lhs, const RhsTy& rhs)
+    {
+        return Internal::MakeBinaryExpr<Internal::VecAddOp>(lhs, rhs);
+    }
+
+    /**
+     * @brief Subtracts the right operand of a lazy expression from the left.
+     */
+    template<typename LhsTy, typename RhsTy>
+        requires Internal::LazyOperands<LhsTy, RhsTy> && Internal::CanSub<Internal::LazyValueT<LhsTy>, Internal::LazyValueT<RhsTy>>
+    constexpr auto operator- (const LhsTy& lhs, const RhsTy& rhs)
+    {
+        return Internal::MakeBinaryExpr<Internal::VecSubOp>(lhs, rhs);
+    }
+
+    /**
+     * @brief Multiplies two operands of a lazy expression together.
+     */
+    template<typename LhsTy, typename RhsTy>
+        requires Internal::LazyOperands<LhsTy, RhsTy> && Internal::CanMul<Internal::LazyValueT<LhsTy>, Internal::LazyValueT<RhsTy>>
+    constexpr auto operator* (const LhsTy& lhs, const RhsTy& rhs)
+    {
+        return Internal::MakeBinaryExpr<Internal::VecMulOp>(lhs, rhs);
+    }
+
+    /**
+     * @brief Divides the left operand of a lazy expression by the right.
+     */
+    template<typename LhsTy, typename RhsTy>
+        requires Internal::LazyOperands<LhsTy, RhsTy> && Internal::CanDiv<Internal::LazyValueT<LhsTy>, Internal::LazyValueT<RhsTy>>
+    constexpr auto operator/ (const LhsTy& lhs, const RhsTy& rhs)
+    {
+        return Internal::MakeBinaryExpr<Internal::VecDivOp>(lhs, rhs);
+    }
+
+    /* Compound assignment evaluates the expression straight into the vector */
+    #ifndef DOXYGEN_HIDE
+
+    template<std::size_t len, typename Ty, typename Layout, typename Expr>
+        requires Internal::IsVecExpr<Expr> && (Expr::length == len) &&
+            Internal::CanAdd<Ty, typename Expr::ValueType> && std::is_same_v<Ty, Internal::AddResultT<Ty, typename Expr::ValueType>>
+    constexpr Vec<len, Ty, Layout>& operator+= (Vec<len, Ty, Layout>& vec, const Expr& expr)
+    {
+        for (std::size_t index = 0; index < len; index++)
+            vec[index] += expr[index];
+
+        return vec;
+    }
+
+    template<std::size_t len, typename Ty, typename Layout, typename Expr>
+        requires Internal::IsVecExpr<Expr> && (Expr::length == len) &&
+            Internal::CanSub<Ty, typename Expr::ValueType> && std::is_same_v<Ty, Internal::SubResultT<Ty, typename Expr::ValueType>>
+    constexpr Vec<len, Ty, Layout>& operator-= (Vec<len, Ty, Layout>& vec, const Expr& expr)
+    {
+        for (std::size_t index = 0; index < len; index++)
+            vec[index] -= expr[index];
+
+        return vec;
+    }
+
+    template<std::size_t len, typename Ty, typename Layout, typename Expr>
+        requires Internal::IsVecExpr<Expr> && (Expr::length == len) &&
+            Internal::CanMul<Ty, typename Expr::ValueType> && std::is_same_v<Ty, Internal::MulResultT<Ty, typename Expr::ValueType>>
+    constexpr Vec<len, Ty, Layout>& operator*= (Vec<len, Ty, Layout>& vec, const Expr& expr)
+    {
+        for (std::size_t index = 0; index < len; index++)
+            vec[index] *= expr[index];
+
+        return vec;
+    }
+
+    template<std::size_t len, typename Ty, typename Layout, typename Expr>
+        requires Internal::IsVecExpr<Expr> && (Expr::length == len) &&
+            Internal::CanDiv<Ty, typename Expr::ValueType> && std::is_same_v<Ty, Internal::DivResultT<Ty, typename Expr::ValueType>>
+    constexpr Vec<len, Ty, Layout>& operator/= (Vec<len, Ty, Layout>& vec, const Expr& expr)
+    {
+        for (std::size_t index = 0; index < len; index++)
+            vec[index] /= expr[index];
+
+        return vec;
+    }
+
+    #endif // DOXYGEN_HIDE
+}
@@ -0,0 +1,329 @@
+#pragma once
+
+#include <classes/Vec.h>
+
+#include <type_traits>
+#include <utility>
+#include <cstddef>
+#include <cmath>
+
+/**
+ * @file VecMath.h
+ *
+ * @brief Contains the free functions for vector math on Vec<len, Ty>
+ *        such as the dot product, length, normalization, element-wise
+ *        min / max / abs and horizontal reductions.
+ *
+ * @details Every function apart from those that need a square root is
+ *          constexpr so can be used to calculate vectors at compile time.
+ *          Vec3<float>, Vec4<float> and Vec4<int> use SIMD kernels for most
+ *          functions, other vectors use unrolled scalar code.
+ */
+
+namespace PashaBibko::Util
+{
+    /**
+     * @brief Returns the dot product of two vectors.
+     *
+     * @details The sum of each element multiplied by the same element of the other
+     *          vector. Requires the types to be able to be multiplied together and
+     *          the result of that to be able to be added to itself.
+     *
+     * @note Vec3<float>, Vec4<float> and Vec4<int> use SIMD instructions which add
+     *       the products in pairs, so floats may differ in the last bit from adding
+     *       them in order.
+     */
+    template<std::size_t len, typename LhsTy, typename RhsTy, typename Layout, typename ResTy = Internal::MulResultT<LhsTy, RhsTy>>
+        requires Internal::CanMul<LhsTy, RhsTy> && Internal::CanAdd<ResTy, ResTy>
+    constexpr ResTy Dot(const Vec<len, LhsTy, Layout>& lhs, const Vec<len, RhsTy, Layout>& rhs)
+    {
+        if constexpr (std::is_same_v<LhsTy, RhsTy> && std::is_same_v<LhsTy, ResTy> && Internal::SimdDot<len, ResTy>)
+        {
+            if (!std::is_constant_evaluated())
+                return Internal::VecSimd<len, ResTy>::Dot(lhs.data, rhs.data);
+        }
+
+        return [&]<std::size_t... index>(std::index_sequence<index...>) { return static_cast<ResTy>(((lhs[index] * rhs[index]) + ...)); } (std::make_index_sequence<len>{});
+    }
+
+    /**
+     * @brief Returns the length of a vector squared.
+     *
+     * @details Avoids the square root of Length() so is cheaper when only
+     *          comparing lengths against each other.
+     */
+    template<std::size_t len, typename Ty, typename Layout>
+        requires Internal::CanMul<Ty, Ty> && Internal::CanAdd<Internal::MulResultT<Ty, Ty>, Internal::MulResultT<Ty, Ty>>
+    constexpr Internal::MulResultT<Ty, Ty> LengthSquared(const Vec<len, Ty, Layout>& vec)
+    {
+        return Dot(vec, vec);
+    }
+
+    /**
+     * @brief Returns the length (magnitude) of a vector.
+     *
+     * @details Only available for vectors of floating point types.
+     */
+    template<std::size_t len, typename Ty, typename Layout>
+        requires std::is_floating_point_v<Ty>
+    Ty Length(const Vec<len, Ty, Layout>& vec)
+    {
+        return std::sqrt(Dot(vec, vec));
+    }
+
+    /**
+     * @brief Returns the vector scaled to have a length of 1.
+     *
+     * @details Only available for vectors of floating point types.
+     *
+     * @warning A vector with a length of 0 has no direction,
+     *          normalizing it will return a vector of NaN.
+     */
+    template<std::size_t len, typename Ty, typename Layout>
+        requires std::is_floating_point_v<Ty>
+    Vec<len, Ty, Layout> Normalize(const Vec<len, Ty, Layout>& vec)
+    {
+        if constexpr (Internal::SimdNormalize<len, Ty>)
+        {
+            Vec<len, Ty, Layout> out;
+            Internal::VecSimd<len, Ty>::Normalize(vec.data, out.data);
+            return out;
+        }
+
+        else
+        {
+            const Ty length = Length(vec);
+            return [&]<std::size_t... index>(std::index_sequence<index...>) { return Vec<len, Ty, Layout>{ (vec[index] / length)... }; } (std::make_index_sequence<len>{});
+        }
+    }
+
+    /**
+     * @brief Returns the vector scaled to have a length of approximately 1.
+     *
+     * @details Faster than Normalize() as it multiplies by an approximate reciprocal
+     *          square root instead of dividing by the length. Float vectors with a SIMD
+     *          kernel are accurate to around 22 bits, other vectors multiply by the
+     *          exact reciprocal. Only available for vectors of floating point types.
+     *
+     * @warning A vector with a length of 0 has no direction,
+     *          normalizing it will return a vector of NaN.
+     */
+    template<std::size_t len, typename Ty, typename Layout>
+        requires std::is_floating_point_v<Ty>
+    Vec<len, Ty, Layout> NormalizeFast(const Vec<len, Ty, Layout>& vec)
+    {
+        if constexpr (Internal::SimdNormalizeFast<len, Ty>)
+        {
+            Vec<len, Ty, Layout> out;
+            Internal::VecSimd<len, Ty>::NormalizeFast(vec.data, out.data);
+            return out;
+        }
+
+        else
+        {
+            const Ty reciprocal = Ty(1) / Length(vec);
+            return [&]<std::size_t... index>(std::index_sequence<index...>) { return Vec<len, Ty, Layout>{ (vec[index] * reciprocal)... }; } (std::make_index_sequence<len>{});
+        }
+    }
+
+    /**
+     * @brief Returns the cross product of two 3D vectors.
+     *
+     * @details The result is perpendicular to both vectors with a length equal to the
+     *          area of the parallelogram they form. Follows the right hand rule.
+     */
+    template<typename LhsTy, typename RhsTy, typename Layout, typename ResTy = Internal::SubResultT<Internal::MulResultT<LhsTy, RhsTy>, Internal::MulResultT<LhsTy, RhsTy>>>
+        requires Internal::CanMul<LhsTy, RhsTy> && Internal::CanSub<Internal::MulResultT<LhsTy, RhsTy>, Internal::MulResultT<LhsTy, RhsTy>>
+    constexpr Vec<3, ResTy, Layout> Cross(const Vec<3, LhsTy, Layout>& lhs, const Vec<3, RhsTy, Layout>& rhs)
+    {
+        return Vec<3, ResTy, Layout>
+        {
+            static_cast<ResTy>(lhs[1] * rhs[2] - lhs[2] * rhs[1]),
+            static_cast<ResTy>(lhs[2] * rhs[0] - lhs[0] * rhs[2]),
+            static_cast<ResTy>(lhs[0] * rhs[1] - lhs[1] * rhs[0])
+        };
+    }
+
+    /**
+     * @brief Linearly interpolates between two vectors.
+     *
+     * @param from The vector returned when t is 0.
+     * @param to The vector returned when t is 1.
+     * @param t How far between the two vectors, values outside of [0, 1] extrapolate.
+     */
+    template<std::size_t len, typename Ty, typename Layout>
+        requires std::is_floating_point_v<Ty>
+    constexpr Vec<len, Ty, Layout> Lerp(const Vec<len, Ty, Layout>& from, const Vec<len, Ty, Layout>& to, Ty t)
+    {
+        return [&]<std::size_t... index>(std::index_sequence<index...>) { return Vec<len, Ty, Layout>{ (from[index] + (to[index] - from[index]) * t)... }; } (std::make_index_sequence<len>{});
+    }
+
+    /**
+     * @brief Returns the smaller of each element of the two vectors.
+     *
+     * @details If the elements are not ordered (such as NaN) the right element is returned,
+     *          apart from on ARM64 where the SIMD kernels return NaN.
+     */
+    template<std::size_t len, typename Ty, typename Layout>
+    constexpr Vec<len, Ty, Layout> Min(const Vec<len, Ty, Layout>& lhs, const Vec<len, Ty, Layout>& rhs)
+    {
+        if constexpr (Internal::SimdMin<len, Ty>)
+        {
+            if (!std::is_constant_evaluated())
+            {
+                Vec<len, Ty, Layout> out;
+                Internal::VecSimd<len, Ty>::Min(lhs.data, rhs.data, out.data);
+                return out;
+            }
+        }
+
+        return [&]<std::size_t... index>(std::index_sequence<index...>) { return Vec<len, Ty, Layout>{ (lhs[index] < rhs[index] ? lhs[index] : rhs[index])... }; } (std::make_index_sequence<len>{});
+    }
+
+    /**
+     * @brief Returns the larger of each element of the two vectors.
+     *
+     * @details If the elements are not ordered (such as NaN) the right element is returned,
+     *          apart from on ARM64 where the SIMD kernels return NaN.
+     */
+    template<std::size_t len, typename Ty, typename Layout>
+    constexpr Vec<len, Ty, Layout> Max(const Vec<len, Ty, Layout>& lhs, const Vec<len, Ty, Layout>& rhs)
+    {
+        if constexpr (Internal::SimdMax<len, Ty>)
+        {
+            if (!std::is_constant_evaluated())
+            {
+                Vec<len, Ty, Layout> out;
+                Internal::VecSimd<len, Ty>::Max(lhs.data, rhs.data, out.data);
+                return out;
+            }
+        }
+
+        return [&]<std::size_t... index>(std::index_sequence<index...>) { return Vec<len, Ty, Layout>{ (rhs[index] < lhs[index] ? lhs[index] : rhs[index])... }; } (std::make_index_sequence<len>{});
+    }
+
+    /**
+     * @brief Limits each element of the vector to be within the same element of the bounds.
+     *
+     * @warning Each element of low must not be greater than the same element of high.
+     */
+    template<std::size_t len, typename Ty, typename Layout>
+    constexpr Vec<len, Ty, Layout> Clamp(const Vec<len, Ty, Layout>& vec, const Vec<len, Ty, Layout>& low, const Vec<len, Ty, Layout>& high)
+    {
+        return Min(Max(vec, low), high);
+    }
+
+    /**
+     * @brief Returns the absolute value of each element.
+     *
+     * @details Only available for vectors of signed types. -0.0 becomes 0.0 like std::abs.
+     *
+     * @warning The absolute value of the lowest value of a signed integer cannot be
+     *          represented and is classified as UB.
+     */
+    template<std::size_t len, typename Ty, typename Layout>
+        requires std::is_signed_v<Ty>
+    constexpr Vec<len, Ty, Layout> Abs(const Vec<len, Ty, Layout>& vec)
+    {
+        if constexpr (Internal::SimdAbs<len, Ty>)
+        {
+            if (!std::is_constant_evaluated())
+            {
+                Vec<len, Ty, Layout> out;
+                Internal::VecSimd<len, Ty>::Abs(vec.data, out.data);
+                return out;
+            }
+        }
+
+        /* Adding 0 turns -0.0 into 0.0 and does nothing to other values */
+        return [&]<std::size_t... index>(std::index_sequence<index...>)
+        {
+            return Vec<len, Ty, Layout>{ static_cast<Ty>(vec[index] < Ty(0) ? -vec[index] : vec[index] + Ty(0))... };
+        } (std::make_index_sequence<len>{});
+    }
+
+    /**
+     * @brief Returns lhs * rhs + add for each element.
+     *
+     * @details Does the multiplication and addition in one pass over the vectors. It is not
+     *          a fused multiply-add, the result is rounded after the multiply so it is the
+     *          same as writing the expression with the operators.
+     */
+    template<std::size_t len, typename Ty, typename Layout>
+        requires Internal::CanMul<Ty, Ty> && Internal::CanAdd<Internal::MulResultT<Ty, Ty>, Ty>
+    constexpr Vec<len, Ty, Layout> MulAdd(const Vec<len, Ty, Layout>& lhs, const Vec<len, Ty, Layout>& rhs, const Vec<len, Ty, Layout>& add)
+    {
+        if constexpr (Internal::SimdMulAdd<len, Ty>)
+        {
+            if (!std::is_constant_evaluated())
+            {
+                Vec<len, Ty, Layout> out;
+                Internal::VecSimd<len, Ty>::MulAdd(lhs.data, rhs.data, add.data, out.data);
+                return out;
+            }
+        }
+
+        return [&]<std::size_t... index>(std::index_sequence<index...>)
+        {
+            return Vec<len, Ty, Layout>{ static_cast<Ty>(lhs[index] * rhs[index] + add[index])... };
+        } (std::make_index_sequence<len>{});
+    }
+
+    /**
+     * @brief Returns the sum of every element of the vector.
+     *
+     * @note Like Dot(), vectors with a SIMD kernel add the elements in pairs.
+     */
+    template<std::size_t len, typename Ty, typename Layout, typename ResTy = Internal::AddResultT<Ty, Ty>>
+        requires Internal::CanAdd<Ty, Ty>
+    constexpr ResTy Sum(const Vec<len, Ty, Layout>& vec)
+    {
+        if constexpr (std::is_same_v<Ty, ResTy> && Internal::SimdSum<len, Ty>)
+        {
+            if (!std::is_constant_evaluated())
+                return Internal::VecSimd<len, Ty>::Sum(vec.data);
+        }
+
+        return [&]<std::size_t... index>(std::index_sequence<index...>) { return static_cast<ResTy>((... + vec[index])); } (std::make_index_sequence<len>{});
+    }
+
+    /**
+     * @brief Returns the smallest element of the vector.
+     */
+    template<std::size_t len, typename Ty, typename Layout>
+    constexpr Ty MinElement(const Vec<len, Ty, Layout>& vec)
+    {
+        if constexpr (Internal::SimdMinElement<len, Ty>)
+        {
+            if (!std::is_constant_evaluated())
+                return Internal::VecSimd<len, Ty>::MinElement(vec.data);
+        }
+
+        return [&]<std::size_t... index>(std::index_sequence<index...>)
+        {
+            Ty result = vec[0];
+            ((result = vec[index] < result ? vec[index] : result), ...);
+            return result;
+        } (std::make_index_sequence<len>{});
+    }
+
+    /**
+     * @brief Returns the largest element of the vector.
+     */
+    template<std::size_t len, typename Ty, typename Layout>
+    constexpr Ty MaxElement(const Vec<len, Ty, Layout>& vec)
+    {
+        if constexpr (Internal::SimdMaxElement<len, Ty>)
+        {
+            if (!std::is_constant_evaluated())
+                return Internal::VecSimd<len, Ty>::MaxElement(vec.data);
+        }
+
+        return [&]<std::size_t... index>(std::index_sequence<index...>)
+        {
+            Ty result = vec[0];
+            ((result = result < vec[index] ? vec[index] : result), ...);
+            return result;
+        } (std::make_index_sequence<len>{});
+    }
+}
@@ -0,0 +1,536 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+
+/**
+ * @file VecSimd.h
+ *
+ * @brief Contains the SIMD kernels used by Vec<len, Ty> for the lengths and types
+ *        that fit in a single register, and by Mat<rows, cols, Ty> for 4x4 matrices.
+ *        Included by Vec.h so does not need to be included directly.
+ *
+ * @details Kernels are picked at compile time, on x86-64 SSE2 is used (with SSE4.1
+ *          for integer multiplication if the compiler is targeting it) and on ARM64
+ *          NEON is used. Defining PBU_VEC_NO_SIMD before including the library will
+ *          make every Vec use the scalar operators instead.
+ */
+
+#if !defined(PBU_VEC_NO_SIMD)
+    #if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        #define PBU_VEC_SSE2
+        #include <emmintrin.h>
+
+        #if defined(__SSE4_1__) || defined(__AVX__)
+            #define PBU_VEC_SSE41
+            #include <smmintrin.h>
+        #endif
+
+    #elif defined(__ARM_NEON) || defined(_M_ARM64)
+        #define PBU_VEC_NEON
+        #include <arm_neon.h>
+
+    #endif
+#endif
+
+namespace PashaBibko::Util
+{
+    /* Excludes the internal namespace from the documentation */
+    #ifndef DOXYGEN_HIDE
+
+    namespace Internal
+    {
+        /*
+         * Kernels work on pointers to the elements so they do not depend on the layout of Vec.
+         * A specialization only needs to provide the functions it can do faster than the scalar
+         * loop, each operator checks for the function it needs with the concepts below.
+         *
+         * The floating point results are the same as the scalar operators apart from Dot() and Sum()
+         * which add the lanes in pairs instead of in order so may differ in the last bit, and
+         * NormalizeFast() which uses an approximate reciprocal square root.
+         */
+        template<std::size_t len, typename Ty>
+        struct VecSimd {};
+
+        /*
+         * Matrix kernels take the matrix as its columns stored one after the other. Transform()
+         * multiplies each of count vectors by the matrix, which is also used for multiplying
+         * two matrices as each column of the result is the left matrix times a column of the right.
+         * The products are added in column order so the results match the scalar code exactly.
+         */
+        template<std::size_t rows, std::size_t cols, typename Ty>
+        struct MatSimd {};
+
+        #if defined(PBU_VEC_SSE2)
+
+        /* Vec3<float> is loaded into the first 3 lanes, the last lane is filled with pad */
+        template<std::size_t len>
+        inline __m128 VecLoad(const float* data, float pad = 0.0f)
+        {
+            if constexpr (len == 4)
+                return _mm_loadu_ps(data);
+
+            else
+            {
+                /* Loads [x, y] as one 64 bit value and [z, pad] separately so it does not read past the end */
+                const __m128 xy = _mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(data)));
+                return _mm_movelh_ps(xy, _mm_unpacklo_ps(_mm_load_ss(data + 2), _mm_set_ss(pad)));
+            }
+        }
+
+        template<std::size_t len>
+        inline void VecStore(float* out, __m128 value)
+        {
+            if constexpr (len == 4)
+                _mm_storeu_ps(out, value);
+
+            else
+            {
+                /* Stores [x, y] as one 64 bit value like the load, an __m64 access needs 8 byte alignment a float does not have */
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(out), _mm_castps_si128(value));
+                _mm_store_ss(out + 2, _mm_movehl_ps(value, value));
+            }
+        }
+
+        /* Adds all 4 lanes together and broadcasts the result to all of them */
+        inline __m128 VecHorizontalSum(__m128 value)
+        {
+            const __m128 pairs = _mm_add_ps(value, _mm_shuffle_ps(value, value, _MM_SHUFFLE(2, 3, 0, 1)));
+            return _mm_add_ps(pairs, _mm_shuffle_ps(pairs, pairs, _MM_SHUFFLE(1, 0, 3, 2)));
+        }
+
+        inline __m128 VecHorizontalMin(__m128 value)
+        {
+            const __m128 pairs = _mm_min_ps(value, _mm_shuffle_ps(value, value, _MM_SHUFFLE(2, 3, 0, 1)));
+            return _mm_min_ps(pairs, _mm_shuffle_ps(pairs, pairs, _MM_SHUFFLE(1, 0, 3, 2)));
+        }
+
+        inline __m128 VecHorizontalMax(__m128 value)
+        {
+            const __m128 pairs = _mm_max_ps(value, _mm_shuffle_ps(value, value, _MM_SHUFFLE(2, 3, 0, 1)));
+            return _mm_max_ps(pairs, _mm_shuffle_ps(pairs, pairs, _MM_SHUFFLE(1, 0, 3, 2)));
+        }
+
+        template<std::size_t len> requires (len == 3 || len == 4)
+        struct VecSimd<len, float>
+        {
+            static constexpr int mask = (1 << len) - 1;
+
+            static void Add(const float* lhs, const float* rhs, float* out) { VecStore<len>(out, _mm_add_ps(VecLoad<len>(lhs), VecLoad<len>(rhs))); }
+            static void Sub(const float* lhs, const float* rhs, float* out) { VecStore<len>(out, _mm_sub_ps(VecLoad<len>(lhs), VecLoad<len>(rhs))); }
+            static void Mul(const float* lhs, const float* rhs, float* out) { VecStore<len>(out, _mm_mul_ps(VecLoad<len>(lhs), VecLoad<len>(rhs))); }
+
+            /* The unused lane is divided by 1 so it does not raise a floating point exception */
+            static void Div(const float* lhs, const float* rhs, float* out) { VecStore<len>(out, _mm_div_ps(VecLoad<len>(lhs), VecLoad<len>(rhs, 1.0f))); }
+
+            /* Scalars are broadcast to every lane, apart from the unused lane of a divisor which is 1 */
+            static __m128 Divisor(float value) { return len == 4 ? _mm_set1_ps(value) : _mm_setr_ps(value, value, value, 1.0f); }
+
+            static void AddScalar(const float* lhs, float rhs, float* out) { VecStore<len>(out, _mm_add_ps(VecLoad<len>(lhs), _mm_set1_ps(rhs))); }
+            static void SubScalar(const float* lhs, float rhs, float* out) { VecStore<len>(out, _mm_sub_ps(VecLoad<len>(lhs), _mm_set1_ps(rhs))); }
+            static void MulScalar(const float* lhs, float rhs, float* out) { VecStore<len>(out, _mm_mul_ps(VecLoad<len>(lhs), _mm_set1_ps(rhs))); }
+            static void DivScalar(const float* lhs, float rhs, float* out) { VecStore<len>(out, _mm_div_ps(VecLoad<len>(lhs), Divisor(rhs))); }
+            static void ScalarSub(float lhs, const float* rhs, float* out) { VecStore<len>(out, _mm_sub_ps(_mm_set1_ps(lhs), VecLoad<len>(rhs))); }
+            static void ScalarDiv(float lhs, const float* rhs, float* out) { VecStore<len>(out, _mm_div_ps(_mm_set1_ps(lhs), VecLoad<len>(rhs, 1.0f))); }
+
+            static bool Equal(const float* lhs, const float* rhs)
+            {
+                return (_mm_movemask_ps(_mm_cmpeq_ps(VecLoad<len>(lhs), VecLoad<len>(rhs))) & mask) == mask;
+            }
+
+            static float Dot(const float* lhs, const float* rhs)
+            {
+                return _mm_cvtss_f32(VecHorizontalSum(_mm_mul_ps(VecLoad<len>(lhs), VecLoad<len>(rhs))));
+            }
+
+            static void Normalize(const float* in, float* out)
+            {
+                const __m128 value = VecLoad<len>(in);
+                const __m128 length = _mm_sqrt_ps(VecHorizontalSum(_mm_mul_ps(value, value)));
+                VecStore<len>(out, _mm_div_ps(value, length));
+            }
+
+            /* rsqrt is only accurate to 12 bits, one Newton-Raphson step brings it to about 22 */
+            static void NormalizeFast(const float* in, float* out)
+            {
+                const __m128 value = VecLoad<len>(in);
+                const __m128 squared = VecHorizontalSum(_mm_mul_ps(value, value));
+                const __m128 estimate = _mm_rsqrt_ps(squared);
+
+                const __m128 halfSquared = _mm_mul_ps(_mm_set1_ps(0.5f), squared);
+                const __m128 refined = _mm_mul_ps(estimate, _mm_sub_ps(_mm_set1_ps(1.5f), _mm_mul_ps(halfSquared, _mm_mul_ps(estimate, estimate))));
+                VecStore<len>(out, _mm_mul_ps(value, refined));
+            }
+
+            static void Min(const float* lhs, const float* rhs, float* out) { VecStore<len>(out, _mm_min_ps(VecLoad<len>(lhs), VecLoad<len>(rhs))); }
+            static void Max(const float* lhs, const float* rhs, float* out) { VecStore<len>(out, _mm_max_ps(VecLoad<len>(lhs), VecLoad<len>(rhs))); }
+
+            /* Clears the sign bit of each lane */
+            static void Abs(const float* in, float* out) { VecStore<len>(out, _mm_andnot_ps(_mm_set1_ps(-0.0f), VecLoad<len>(in))); }
+
+            /* Kept as a separate multiply and add so the result is the same as the scalar code */
+            static void MulAdd(const float* lhs, const float* rhs, const float* add, float* out)
+            {
+                VecStore<len>(out, _mm_add_ps(_mm_mul_ps(VecLoad<len>(lhs), VecLoad<len>(rhs)), VecLoad<len>(add)));
+            }
+
+            static float Sum(const float* in) { return _mm_cvtss_f32(VecHorizontalSum(VecLoad<len>(in))); }
+
+            /* The unused lane is filled with the first element so it does not change the result */
+            static float MinElement(const float* in) { return _mm_cvtss_f32(VecHorizontalMin(VecLoad<len>(in, in[0]))); }
+            static float MaxElement(const float* in) { return _mm_cvtss_f32(VecHorizontalMax(VecLoad<len>(in, in[0]))); }
+        };
+
+        template<>
+        struct VecSimd<4, int>
+        {
+            static __m128i Load(const int* data) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(data)); }
+            static void Store(int* out, __m128i value) { _mm_storeu_si128(reinterpret_cast<__m128i*>(out), value); }
+
+            /* SSE2 only has an unsigned 32 bit multiply for lanes 0 and 2 so it is done twice and combined */
+            static __m128i Multiply(__m128i lhs, __m128i rhs)
+            {
+                #if defined(PBU_VEC_SSE41)
+                    return _mm_mullo_epi32(lhs, rhs);
+
+                #else
+                    const __m128i even = _mm_mul_epu32(lhs, rhs);
+                    const __m128i odd = _mm_mul_epu32(_mm_srli_si128(lhs, 4), _mm_srli_si128(rhs, 4));
+                    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+
+                #endif
+            }
+
+            /* Picks the lane from lhs where the mask is set and from rhs where it is not */
+            static __m128i Select(__m128i mask, __m128i lhs, __m128i rhs)
+            {
+                return _mm_or_si128(_mm_and_si128(mask, lhs), _mm_andnot_si128(mask, rhs));
+            }
+
+            static __m128i Plus(__m128i lhs, __m128i rhs) { return _mm_add_epi32(lhs, rhs); }
+
+            static __m128i Minimum(__m128i lhs, __m128i rhs)
+            {
+                #if defined(PBU_VEC_SSE41)
+                    return _mm_min_epi32(lhs, rhs);
+
+                #else
+                    return Select(_mm_cmplt_epi32(lhs, rhs), lhs, rhs);
+
+                #endif
+            }
+
+            static __m128i Maximum(__m128i lhs, __m128i rhs)
+            {
+                #if defined(PBU_VEC_SSE41)
+                    return _mm_max_epi32(lhs, rhs);
+
+                #else
+                    return Select(_mm_cmpgt_epi32(lhs, rhs), lhs, rhs);
+
+                #endif
+            }
+
+            /* Reduces all 4 lanes with the function, the result is in the first lane */
+            template<typename Func>
+            static int Reduce(__m128i value, Func func)
+            {
+                const __m128i pairs = func(value, _mm_shuffle_epi32(value, _MM_SHUFFLE(2, 3, 0, 1)));
+                return _mm_cvtsi128_si32(func(pairs, _mm_shuffle_epi32(pairs, _MM_SHUFFLE(1, 0, 3, 2))));
+            }
+
+            static void Add(const int* lhs, const int* rhs, int* out) { Store(out, _mm_add_epi32(Load(lhs), Load(rhs))); }
+            static void Sub(const int* lhs, const int* rhs, int* out) { Store(out, _mm_sub_epi32(Load(lhs), Load(rhs))); }
+            static void Mul(const int* lhs, const int* rhs, int* out) { Store(out, Multiply(Load(lhs), Load(rhs))); }
+
+            static void AddScalar(const int* lhs, int rhs, int* out) { Store(out, _mm_add_epi32(Load(lhs), _mm_set1_epi32(rhs))); }
+            static void SubScalar(const int* lhs, int rhs, int* out) { Store(out, _mm_sub_epi32(Load(lhs), _mm_set1_epi32(rhs))); }
+            static void MulScalar(const int* lhs, int rhs, int* out) { Store(out, Multiply(Load(lhs), _mm_set1_epi32(rhs))); }
+            static void ScalarSub(int lhs, const int* rhs, int* out) { Store(out, _mm_sub_epi32(_mm_set1_epi32(lhs), Load(rhs))); }
+
+            static bool Equal(const int* lhs, const int* rhs)
+            {
+                return _mm_movemask_epi8(_mm_cmpeq_epi32(Load(lhs), Load(rhs))) == 0xFFFF;
+            }
+
+            static int Dot(const int* lhs, const int* rhs)
+            {
+                return Reduce(Multiply(Load(lhs), Load(rhs)), Plus);
+            }
+
+            static void Min(const int* lhs, const int* rhs, int* out) { Store(out, Minimum(Load(lhs), Load(rhs))); }
+            static void Max(const int* lhs, const int* rhs, int* out) { Store(out, Maximum(Load(lhs), Load(rhs))); }
+
+            static void Abs(const int* in, int* out)
+            {
+                #if defined(PBU_VEC_SSE41)
+                    Store(out, _mm_abs_epi32(Load(in)));
+
+                #else
+                    /* Negative lanes are flipped and have 1 added, positive lanes are left as they are */
+                    const __m128i value = Load(in);
+                    const __m128i sign = _mm_srai_epi32(value, 31);
+                    Store(out, _mm_sub_epi32(_mm_xor_si128(value, sign), sign));
+
+                #endif
+            }
+
+            static void MulAdd(const int* lhs, const int* rhs, const int* add, int* out)
+            {
+                Store(out, _mm_add_epi32(Multiply(Load(lhs), Load(rhs)), Load(add)));
+            }
+
+            static int Sum(const int* in) { return Reduce(Load(in), Plus); }
+            static int MinElement(const int* in) { return Reduce(Load(in), Minimum); }
+            static int MaxElement(const int* in) { return Reduce(Load(in), Maximum); }
+        };
+
+        template<>
+        struct MatSimd<4, 4, float>
+        {
+            static void Transform(const float* mat, const float* in, float* out, std::size_t count)
+            {
+                const __m128 column0 = _mm_loadu_ps(mat);
+                const __m128 column1 = _mm_loadu_ps(mat + 4);
+                const __m128 column2 = _mm_loadu_ps(mat + 8);
+                const __m128 column3 = _mm_loadu_ps(mat + 12);
+
+                for (std::size_t index = 0; index < count; index++, in += 4, out += 4)
+                {
+                    const __m128 vec = _mm_loadu_ps(in);
+
+                    __m128 result = _mm_mul_ps(column0, _mm_shuffle_ps(vec, vec, _MM_SHUFFLE(0, 0, 0, 0)));
+                    result = _mm_add_ps(result, _mm_mul_ps(column1, _mm_shuffle_ps(vec, vec, _MM_SHUFFLE(1, 1, 1, 1))));
+                    result = _mm_add_ps(result, _mm_mul_ps(column2, _mm_shuffle_ps(vec, vec, _MM_SHUFFLE(2, 2, 2, 2))));
+                    result = _mm_add_ps(result, _mm_mul_ps(column3, _mm_shuffle_ps(vec, vec, _MM_SHUFFLE(3, 3, 3, 3))));
+
+                    _mm_storeu_ps(out, result);
+                }
+            }
+        };
+
+        #elif defined(PBU_VEC_NEON)
+
+        /* Vec3<float> is loaded into the first 3 lanes, the last lane is filled with pad */
+        template<std::size_t len>
+        inline float32x4_t VecLoad(const float* data, float pad = 0.0f)
+        {
+            if constexpr (len == 4)
+                return vld1q_f32(data);
+
+            else
+                return vcombine_f32(vld1_f32(data), vld1_lane_f32(data + 2, vdup_n_f32(pad), 0));
+        }
+
+        template<std::size_t len>
+        inline void VecStore(float* out, float32x4_t value)
+        {
+            if constexpr (len == 4)
+                vst1q_f32(out, value);
+
+            else
+            {
+                vst1_f32(out, vget_low_f32(value));
+                vst1q_lane_f32(out + 2, value, 2);
+            }
+        }
+
+        template<std::size_t len> requires (len == 3 || len == 4)
+        struct VecSimd<len, float>
+        {
+            static void Add(const float* lhs, const float* rhs, float* out) { VecStore<len>(out, vaddq_f32(VecLoad<len>(lhs), VecLoad<len>(rhs))); }
+            static void Sub(const float* lhs, const float* rhs, float* out) { VecStore<len>(out, vsubq_f32(VecLoad<len>(lhs), VecLoad<len>(rhs))); }
+            static void Mul(const float* lhs, const float* rhs, float* out) { VecStore<len>(out, vmulq_f32(VecLoad<len>(lhs), VecLoad<len>(rhs))); }
+            static void Div(const float* lhs, const float* rhs, float* out) { VecStore<len>(out, vdivq_f32(VecLoad<len>(lhs), VecLoad<len>(rhs, 1.0f))); }
+
+            /* Scalars are broadcast to every lane, apart from the unused lane of a divisor which is 1 */
+            static float32x4_t Divisor(float value) { return len == 4 ? vdupq_n_f32(value) : vsetq_lane_f32(1.0f, vdupq_n_f32(value), 3); }
+
+            static void AddScalar(const float* lhs, float rhs, float* out) { VecStore<len>(out, vaddq_f32(VecLoad<len>(lhs), vdupq_n_f32(rhs))); }
+            static void SubScalar(const float* lhs, float rhs, float* out) { VecStore<len>(out, vsubq_f32(VecLoad<len>(lhs), vdupq_n_f32(rhs))); }
+            static void MulScalar(const float* lhs, float rhs, float* out) { VecStore<len>(out, vmulq_n_f32(VecLoad<len>(lhs), rhs)); }
+            static void DivScalar(const float* lhs, float rhs, float* out) { VecStore<len>(out, vdivq_f32(VecLoad<len>(lhs), Divisor(rhs))); }
+            static void ScalarSub(float lhs, const float* rhs, float* out) { VecStore<len>(out, vsubq_f32(vdupq_n_f32(lhs), VecLoad<len>(rhs))); }
+            static void ScalarDiv(float lhs, const float* rhs, float* out) { VecStore<len>(out, vdivq_f32(vdupq_n_f32(lhs), VecLoad<len>(rhs, 1.0f))); }
+
+            /* The unused lane is loaded as equal on both sides */
+            static bool Equal(const float* lhs, const float* rhs)
+            {
+                return vminvq_u32(vceqq_f32(VecLoad<len>(lhs), VecLoad<len>(rhs))) != 0;
+            }
+
+            static float Dot(const float* lhs, const float* rhs)
+            {
+                return vaddvq_f32(vmulq_f32(VecLoad<len>(lhs), VecLoad<len>(rhs)));
+            }
+
+            static void Normalize(const float* in, float* out)
+            {
+                const float32x4_t value = VecLoad<len>(in);
+                const float32x4_t length = vsqrtq_f32(vdupq_n_f32(vaddvq_f32(vmulq_f32(value, value))));
+                VecStore<len>(out, vdivq_f32(value, length));
+            }
+
+            /* The estimate is only accurate to 8 bits, two Newton-Raphson steps bring it to about 22 */
+            static void NormalizeFast(const float* in, float* out)
+            {
+                const float32x4_t value = VecLoad<len>(in);
+                const float32x4_t squared = vdupq_n_f32(vaddvq_f32(vmulq_f32(value, value)));
+
+                float32x4_t estimate = vrsqrteq_f32(squared);
+                estimate = vmulq_f32(estimate, vrsqrtsq_f32(vmulq_f32(squared, estimate), estimate));
+                estimate = vmulq_f32(estimate, vrsqrtsq_f32(vmulq_f32(squared, estimate), estimate));
+                VecStore<len>(out, vmulq_f32(value, estimate));
+            }
+
+            static void Min(const float* lhs, const float* rhs, float* out) { VecStore<len>(out, vminq_f32(VecLoad<len>(lhs), VecLoad<len>(rhs))); }
+            static void Max(const float* lhs, const float* rhs, float* out) { VecStore<len>(out, vmaxq_f32(VecLoad<len>(lhs), VecLoad<len>(rhs))); }
+            static void Abs(const float* in, float* out) { VecStore<len>(out, vabsq_f32(VecLoad<len>(in))); }
+
+            /* Kept as a separate multiply and add so the result is the same as the scalar code */
+            static void MulAdd(const float* lhs, const float* rhs, const float* add, float* out)
+            {
+                VecStore<len>(out, vaddq_f32(vmulq_f32(VecLoad<len>(lhs), VecLoad<len>(rhs)), VecLoad<len>(add)));
+            }
+
+            static float Sum(const float* in) { return vaddvq_f32(VecLoad<len>(in)); }
+
+            /* The unused lane is filled with the first element so it does not change the result */
+            static float MinElement(const float* in) { return vminvq_f32(VecLoad<len>(in, in[0])); }
+            static float MaxElement(const float* in) { return vmaxvq_f32(VecLoad<len>(in, in[0])); }
+        };
+
+        template<>
+        struct VecSimd<4, int>
+        {
+            static void Add(const int* lhs, const int* rhs, int* out) { vst1q_s32(out, vaddq_s32(vld1q_s32(lhs), vld1q_s32(rhs))); }
+            static void Sub(const int* lhs, const int* rhs, int* out) { vst1q_s32(out, vsubq_s32(vld1q_s32(lhs), vld1q_s32(rhs))); }
+            static void Mul(const int* lhs, const int* rhs, int* out) { vst1q_s32(out, vmulq_s32(vld1q_s32(lhs), vld1q_s32(rhs))); }
+
+            static void AddScalar(const int* lhs, int rhs, int* out) { vst1q_s32(out, vaddq_s32(vld1q_s32(lhs), vdupq_n_s32(rhs))); }
+            static void SubScalar(const int* lhs, int rhs, int* out) { vst1q_s32(out, vsubq_s32(vld1q_s32(lhs), vdupq_n_s32(rhs))); }
+            static void MulScalar(const int* lhs, int rhs, int* out) { vst1q_s32(out, vmulq_n_s32(vld1q_s32(lhs), rhs)); }
+            static void ScalarSub(int lhs, const int* rhs, int* out) { vst1q_s32(out, vsubq_s32(vdupq_n_s32(lhs), vld1q_s32(rhs))); }
+
+            static bool Equal(const int* lhs, const int* rhs)
+            {
+                return vminvq_u32(vceqq_s32(vld1q_s32(lhs), vld1q_s32(rhs))) != 0;
+            }
+
+            static int Dot(const int* lhs, const int* rhs)
+            {
+                return vaddvq_s32(vmulq_s32(vld1q_s32(lhs), vld1q_s32(rhs)));
+            }
+
+            static void Min(const int* lhs, const int* rhs, int* out) { vst1q_s32(out, vminq_s32(vld1q_s32(lhs), vld1q_s32(rhs))); }
+            static void Max(const int* lhs, const int* rhs, int* out) { vst1q_s32(out, vmaxq_s32(vld1q_s32(lhs), vld1q_s32(rhs))); }
+            static void Abs(const int* in, int* out) { vst1q_s32(out, vabsq_s32(vld1q_s32(in))); }
+
+            static void MulAdd(const int* lhs, const int* rhs, const int* add, int* out)
+            {
+                vst1q_s32(out, vmlaq_s32(vld1q_s32(add), vld1q_s32(lhs), vld1q_s32(rhs)));
+            }
+
+            static int Sum(const int* in) { return vaddvq_s32(vld1q_s32(in)); }
+            static int MinElement(const int* in) { return vminvq_s32(vld1q_s32(in)); }
+            static int MaxElement(const int* in) { return vmaxvq_s32(vld1q_s32(in)); }
+        };
+
+        template<>
+        struct MatSimd<4, 4, float>
+        {
+            static void Transform(const float* mat, const float* in, float* out, std::size_t count)
+            {
+                const float32x4_t column0 = vld1q_f32(mat);
+                const float32x4_t column1 = vld1q_f32(mat + 4);
+                const float32x4_t column2 = vld1q_f32(mat + 8);
+                const float32x4_t column3 = vld1q_f32(mat + 12);
+
+                for (std::size_t index = 0; index < count; index++, in += 4, out += 4)
+                {
+                    const float32x4_t vec = vld1q_f32(in);
+
+                    /* Multiply and add are kept separate as a fused multiply-add would round differently */
+                    float32x4_t result = vmulq_laneq_f32(column0, vec, 0);
+                    result = vaddq_f32(result, vmulq_laneq_f32(column1, vec, 1));
+                    result = vaddq_f32(result, vmulq_laneq_f32(column2, vec, 2));
+                    result = vaddq_f32(result, vmulq_laneq_f32(column3, vec, 3));
+
+                    vst1q_f32(out, result);
+                }
+            }
+        };
+
+        #endif
+
+        /* Checks which kernels are available for a given length and type */
+
+        template<std::size_t len, typename Ty>
+        concept SimdAdd = requires(const Ty* in, Ty* out) { VecSimd<len, Ty>::Add(in, in, out); };
+
+        template<std::size_t len, typename Ty>
+        concept SimdSub = requires(const Ty* in, Ty* out) { VecSimd<len, Ty>::Sub(in, in, out); };
+
+        template<std::size_t len, typename Ty>
+        concept SimdMul = requires(const Ty* in, Ty* out) { VecSimd<len, Ty>::Mul(in, in, out); };
+
+        template<std::size_t len, typename Ty>
+        concept SimdDiv = requires(const Ty* in, Ty* out) { VecSimd<len, Ty>::Div(in, in, out); };
+
+        template<std::size_t len, typename Ty>
+        concept SimdAddScalar = requires(const Ty* in, Ty scalar, Ty* out) { VecSimd<len, Ty>::AddScalar(in, scalar, out); };
+
+        template<std::size_t len, typename Ty>
+        concept SimdSubScalar = requires(const Ty* in, Ty scalar, Ty* out) { VecSimd<len, Ty>::SubScalar(in, scalar, out); };
+
+        template<std::size_t len, typename Ty>
+        concept SimdMulScalar = requires(const Ty* in, Ty scalar, Ty* out) { VecSimd<len, Ty>::MulScalar(in, scalar, out); };
+
+        template<std::size_t len, typename Ty>
+        concept SimdDivScalar = requires(const Ty* in, Ty scalar, Ty* out) { VecSimd<len, Ty>::DivScalar(in, scalar, out); };
+
+        template<std::size_t len, typename Ty>
+        concept SimdScalarSub = requires(const Ty* in, Ty scalar, Ty* out) { VecSimd<len, Ty>::ScalarSub(scalar, in, out); };
+
+        template<std::size_t len, typename Ty>
+        concept SimdScalarDiv = requires(const Ty* in, Ty scalar, Ty* out) { VecSimd<len, Ty>::ScalarDiv(scalar, in, out); };
+
+        template<std::size_t len, typename Ty>
+        concept SimdEqual = requires(const Ty* in) { { VecSimd<len, Ty>::Equal(in, in) } -> std::same_as<bool>; };
+
+        template<std::size_t len, typename Ty>
+        concept SimdDot = requires(const Ty* in) { { VecSimd<len, Ty>::Dot(in, in) } -> std::same_as<Ty>; };
+
+        template<std::size_t len, typename Ty>
+        concept SimdNormalize = requires(const Ty* in, Ty* out) { VecSimd<len, Ty>::Normalize(in, out); };
+
+        template<std::size_t len, typename Ty>
+        concept SimdNormalizeFast = requires(const Ty* in, Ty* out) { VecSimd<len, Ty>::NormalizeFast(in, out); };
+
+        template<std::size_t len, typename Ty>
+        concept SimdMin = requires(const Ty* in, Ty* out) { VecSimd<len, Ty>::Min(in, in, out); };
+
+        template<std::size_t len, typename Ty>
+        concept SimdMax = requires(const Ty* in, Ty* out) { VecSimd<len, Ty>::Max(in, in, out); };
+
+        template<std::size_t len, typename Ty>
+        concept SimdAbs = requires(const Ty* in, Ty* out) { VecSimd<len, Ty>::Abs(in, out); };
+
+        template<std::size_t len, typename Ty>
+        concept SimdMulAdd = requires(const Ty* in, Ty* out) { VecSimd<len, Ty>::MulAdd(in, in, in, out); };
+
+        template<std::size_t len, typename Ty>
+        concept SimdSum = requires(const Ty* in) { { VecSimd<len, Ty>::Sum(in) } -> std::same_as<Ty>; };
+
+        template<std::size_t len, typename Ty>
+        concept SimdMinElement = requires(const Ty* in) { { VecSimd<len, Ty>::MinElement(in) } -> std::same_as<Ty>; };
+
+        template<std::size_t len, typename Ty>
+        concept SimdMaxElement = requires(const Ty* in) { { VecSimd<len, Ty>::MaxElement(in) } -> std::same_as<Ty>; };
+
+        template<std::size_t rows, std::size_t cols, typename Ty>
+        concept SimdTransform = requires(const Ty* in, Ty* out, std::size_t count) { MatSimd<rows, cols, Ty>::Transform(in, in, out, count); };
+    }
+
+    #endif // DOXYGEN_HIDE
+}
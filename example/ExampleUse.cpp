@@ -13,6 +13,48 @@ static Util::ReturnVal<int> SafeDivide(int x, int y)
 	return x / y;
 }
 
+/* Vectors can be calculated at compile time, such as this table of directions */
+static constexpr std::array<Util::Vec2i, 4> directions =
+{
+	Util::Vec2i(0, 1), Util::Vec2i(1, 0), Util::Vec2i(0, -1), Util::Vec2i(-1, 0)
+};
+
+static_assert(directions[0] + directions[2] == Util::Vec2i(0, 0));
+static_assert(directions[1] * Util::Vec2i(3) - directions[3] == Util::Vec2i(4, 0));
+static_assert(directions[0] != directions[1]);
+static_assert(Util::Vec3i() == Util::Vec3i(0));
+static_assert(2 * Util::Vec3i(1, 2, 3) - 1 == Util::Vec3i(1, 3, 5));
+static_assert(Util::Vec4<float>(1.0f, 2.0f, 4.0f, 8.0f) / 2.0f == Util::Vec4<float>(0.5f, 1.0f, 2.0f, 4.0f));
+
+static_assert(Util::Dot(directions[0], directions[1]) == 0);
+static_assert(Util::Dot(Util::Vec4<float>(1.0f, 2.0f, 3.0f, 4.0f), Util::Vec4<float>(2.0f)) == 20.0f);
+static_assert(Util::Cross(Util::Vec3<float>(1.0f, 0.0f, 0.0f), Util::Vec3<float>(0.0f, 1.0f, 0.0f)) == Util::Vec3<float>(0.0f, 0.0f, 1.0f));
+static_assert(Util::Lerp(Util::Vec4<float>(0.0f), Util::Vec4<float>(2.0f), 0.25f) == Util::Vec4<float>(0.5f));
+static_assert(Util::Clamp(Util::Vec3i(-5, 5, 15), Util::Vec3i(0), Util::Vec3i(10)) == Util::Vec3i(0, 5, 10));
+static_assert(Util::LengthSquared(Util::Vec3i(1, 2, 2)) == 9);
+static_assert(Util::Abs(Util::Vec4i(-1, 2, -3, 0)) == Util::Vec4i(1, 2, 3, 0));
+static_assert(Util::MulAdd(Util::Vec4<float>(2.0f), Util::Vec4<float>(3.0f), Util::Vec4<float>(1.0f)) == Util::Vec4<float>(7.0f));
+static_assert(Util::Sum(Util::Vec4i(1, 2, 3, 4)) == 10);
+static_assert(Util::MinElement(Util::Vec3<float>(3.0f, -1.0f, 2.0f)) == -1.0f && Util::MaxElement(Util::Vec4i(3, 9, 2, 4)) == 9);
+
+static_assert([]()
+{
+	Util::Vec4<float> vec(1.0f);
+	vec += Util::Vec4<float>(2.0f);
+	vec /= Util::Vec4<float>(3.0f);
+	vec[2] = 4.0f;
+
+	return vec;
+}() == Util::Vec4<float>(1.0f, 1.0f, 4.0f, 1.0f));
+
+static_assert([]()
+{
+	const Util::Vec3<float> a(1.0f, 2.0f, 3.0f);
+	const Util::Vec3<float> b(2.0f);
+
+	return (Util::Lazy(a) * b + a).Eval();
+}() == Util::Vec3<float>(3.0f, 6.0f, 9.0f));
+
 struct LogableExample
 {
 	std::string LogStr() const
@@ -2,13 +2,21 @@
 
 #include <classes/ReturnVal.h>
 
+#include <string_view>
 #include <filesystem>
+#include <iterator>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <span>
 
 /**
  * @file FileRead.h
  * 
- * @brief Contains the function for reading a file as well as the error
- *        that can be returned if the function failed. Also includes
+ * @brief Contains the functions for reading and mapping a file as well as
+ *        the error that can be returned if the function failed. Also includes
  *        function to find location of an index within a string.
  */
 
@@ -29,7 +37,8 @@ namespace PashaBibko::Util
         {
             FileNotFound,       ///< The file path did not point a file location.
             PermissionDenied,   ///< The executable does not have the permissions to read the file.
-            NotAFile            ///< The file path pointed to a folder not a file.
+            NotAFile,           ///< The file path pointed to a folder not a file.
+            ReadFailed          ///< The file was opened but could not be read or mapped.
         };
 
         /**
@@ -51,7 +60,7 @@ namespace PashaBibko::Util
         /**
          * @brief Converts a FileReadError::Reason into a relevant c-string.
          */
-        static const char* const ReasonStr(Reason reason);
+        static const char* ReasonStr(Reason reason);
     };
 
     /**
@@ -60,10 +69,328 @@ namespace PashaBibko::Util
      * @details Will check if the file path is valid and will return a FileReadError
      *          with a relevant error if invalid.
      * 
+     *          The file is read straight into the string using `resize_and_overwrite()` when
+     *          the standard library provides it (C++23), otherwise the string is zero-filled
+     *          first. If the file shrinks whilst it is read the shorter contents are returned.
+     *          If you do not need to own or modify the contents Util::MapFile() avoids the copy
+     *          entirely.
+     * 
      * @param path File path to read from
      */
     ReturnVal<std::string, FileReadError> ReadFile(const std::filesystem::path& path);
 
+    /**
+     * @brief Reads many files to strings at once using a pool of threads.
+     * 
+     * @details Each file is read the same way as PashaBibko::Util::ReadFile() but the reads are
+     *          spread over a pool of worker threads, with the calling thread also taking part.
+     *          Opening and reading small files is mostly spent waiting on the OS, especially when
+     *          they are not cached, so loading them concurrently keeps more requests in flight.
+     *          An exception thrown whilst reading a file, such as running out of memory, is
+     *          returned as FileReadError::ReadFailed for that file instead of being thrown.
+     * 
+     * @code
+     * std::vector<std::filesystem::path> paths = { "a.cfg", "b.cfg", "c.cfg" };
+     * auto files = Util::ReadFiles(paths);
+     * 
+     * for (std::size_t index = 0; index < files.size(); index++)
+     * {
+     *     if (files[index].Failed())
+     *         Util::Log("Failed to read: ", paths[index].string());
+     * }
+     * @endcode
+     * 
+     * @param paths The files to read.
+     * @param threads The most threads to use (including the calling thread). Defaults to 0 which uses
+     *                the amount of hardware threads, or at least 4 as the threads are mostly waiting.
+     * 
+     * @return The result of reading each file, in the same order as the paths.
+     */
+    std::vector<ReturnVal<std::string, FileReadError>> ReadFiles(std::span<const std::filesystem::path> paths, unsigned threads = 0);
+
+    /**
+     * @brief Hints for how a mapped file will be accessed, allowing the OS to read ahead.
+     */
+    enum class MapHint
+    {
+        Normal,     ///< No hint is given.
+        Sequential, ///< The file will be read from start to end, pages can be read ahead aggressively.
+        Random,     ///< The file will be accessed in a random order, reading ahead is wasted work.
+        WillNeed    ///< The whole file will be needed soon so the OS should start reading it now.
+    };
+
+    /**
+     * @brief Read-only view of a file that has been mapped into memory.
+     * 
+     * @details Created by PashaBibko::Util::MapFile(). The contents are read from the file
+     *          by the OS the first time each page is accessed, so no memory is allocated for
+     *          the contents and nothing is copied. The mapping is removed when the object is
+     *          destroyed so any views of it must not outlive it.
+     * 
+     *          Can be moved but not copied. Empty files are represented as an empty view
+     *          with no mapping.
+     * 
+     * @warning If the file is truncated whilst it is mapped, accessing the pages past the new
+     *          end raises SIGBUS on Linux / macOS (or an access violation on Windows). Only map
+     *          files that are not shrunk by other processes, such as a log that is rotated.
+     */
+    class MappedFile final
+    {
+        public:
+            /**
+             * @brief Creates an empty view that is not mapped to any file.
+             */
+            MappedFile() = default;
+
+            /* Only needs to be documented by the class description */
+            #ifndef DOXYGEN_HIDE
+
+            ~MappedFile();
+
+            MappedFile(MappedFile&& other) noexcept;
+            MappedFile& operator=(MappedFile&& other) noexcept;
+
+            MappedFile(const MappedFile&) = delete;
+            MappedFile& operator=(const MappedFile&) = delete;
+
+            #endif // DOXYGEN_HIDE
+
+            /**
+             * @brief Returns the contents of the file as characters.
+             */
+            std::string_view View() const { return std::string_view(m_Data, m_Size); }
+
+            /**
+             * @brief Returns the contents of the file as bytes.
+             */
+            std::span<const std::byte> Bytes() const { return std::span(reinterpret_cast<const std::byte*>(m_Data), m_Size); }
+
+            /**
+             * @brief Returns a pointer to the start of the mapped contents.
+             */
+            const char* Data() const { return m_Data; }
+
+            /**
+             * @brief Returns the size of the file in bytes.
+             */
+            std::size_t Size() const { return m_Size; }
+
+            /**
+             * @brief Changes how the OS expects the mapping to be accessed.
+             * 
+             * @details Uses `madvise()` on Linux. On Windows only MapHint::WillNeed has an
+             *          effect which uses `PrefetchVirtualMemory()`.
+             */
+            void Advise(MapHint hint) const;
+
+        private:
+            /* Only MapFile() can create mappings */
+            friend ReturnVal<MappedFile, FileReadError> MapFile(const std::filesystem::path& path, MapHint hint);
+
+            MappedFile(const char* data, std::size_t size)
+                : m_Data(data), m_Size(size)
+            {}
+
+            const char* m_Data = nullptr;
+            std::size_t m_Size = 0;
+    };
+
+    /**
+     * @brief Maps a file into memory as a read-only view without copying it.
+     * 
+     * @details Returns the same errors as PashaBibko::Util::ReadFile() with
+     *          FileReadError::ReadFailed if the OS could not map the file.
+     * 
+     * @code
+     * Util::ReturnVal<Util::MappedFile, Util::FileReadError> file = Util::MapFile("data.csv", Util::MapHint::Sequential);
+     * if (file.Failed())
+     *     return;
+     * 
+     * std::string_view contents = file.Result().View();
+     * @endcode
+     * 
+     * @param path File path to map.
+     * @param hint How the contents will be accessed, see PashaBibko::Util::MapHint.
+     */
+    ReturnVal<MappedFile, FileReadError> MapFile(const std::filesystem::path& path, MapHint hint = MapHint::Normal);
+
+    /**
+     * @brief Reads a file in fixed-size chunks or lines using a single reusable buffer.
+     * 
+     * @details Created by PashaBibko::Util::StreamFile(). Only one chunk of the file is held in
+     *          memory at a time so files larger than the available memory can be processed.
+     *          The file is read from start to end and the OS is told to read ahead sequentially.
+     * 
+     *          The views returned by the stream point into its buffer so they are only valid
+     *          until the next chunk or line is read. Lines and chunks can be mixed, both continue
+     *          from where the other stopped. Can be moved but not copied.
+     * 
+     * @code
+     * Util::ReturnVal<Util::FileStream, Util::FileReadError> stream = Util::StreamFile("huge.log");
+     * if (stream.Failed())
+     *     return;
+     * 
+     * std::size_t errors = 0;
+     * for (std::string_view line : stream.Result().Lines())
+     * {
+     *     if (line.starts_with("ERROR"))
+     *         errors++;
+     * }
+     * @endcode
+     */
+    class FileStream final
+    {
+        public:
+            /* Iterator and range types are described by Chunks() and Lines() */
+            #ifndef DOXYGEN_HIDE
+
+            template<bool lines>
+            class Iterator final
+            {
+                public:
+                    using value_type = std::string_view;
+                    using difference_type = std::ptrdiff_t;
+
+                    Iterator() = default;
+                    explicit Iterator(FileStream* stream) : m_Stream(stream) { ++*this; }
+
+                    std::string_view operator*() const { return m_Current; }
+
+                    Iterator& operator++()
+                    {
+                        const bool more = lines ? m_Stream->NextLine(m_Current) : m_Stream->NextChunk(m_Current);
+                        if (!more)
+                            m_Stream = nullptr;
+
+                        return *this;
+                    }
+
+                    void operator++(int) { ++*this; }
+
+                    bool operator==(std::default_sentinel_t) const { return m_Stream == nullptr; }
+
+                private:
+                    FileStream* m_Stream = nullptr;
+                    std::string_view m_Current;
+            };
+
+            template<bool lines>
+            struct Range final
+            {
+                FileStream* stream;
+
+                Iterator<lines> begin() const { return Iterator<lines>(stream); }
+                std::default_sentinel_t end() const { return {}; }
+            };
+
+            FileStream() = default;
+            ~FileStream();
+
+            FileStream(FileStream&& other) noexcept;
+            FileStream& operator=(FileStream&& other) noexcept;
+
+            FileStream(const FileStream&) = delete;
+            FileStream& operator=(const FileStream&) = delete;
+
+            #endif // DOXYGEN_HIDE
+
+            /**
+             * @brief Reads the next chunk of the file.
+             * 
+             * @details Every chunk is the chunk size given to Util::StreamFile() apart from
+             *          the last one, or the first one if lines were read before.
+             * 
+             * @param chunk Set to the contents of the chunk.
+             * 
+             * @return False once the end of the file has been reached or a read failed.
+             */
+            bool NextChunk(std::string_view& chunk);
+
+            /**
+             * @brief Reads the next line of the file without the '\n' at the end.
+             * 
+             * @details Lines longer than the chunk size grow the buffer to fit them.
+             *          The final line is returned even if the file does not end in a '\n'.
+             * 
+             * @param line Set to the contents of the line.
+             * 
+             * @return False once the end of the file has been reached or a read failed.
+             */
+            bool NextLine(std::string_view& line);
+
+            /**
+             * @brief Returns a range of every remaining chunk of the file.
+             */
+            Range<false> Chunks() { return { this }; }
+
+            /**
+             * @brief Returns a range of every remaining line of the file.
+             */
+            Range<true> Lines() { return { this }; }
+
+            /**
+             * @brief Returns true if reading the file failed part way through.
+             */
+            bool Failed() const { return m_Failed; }
+
+        private:
+            /* Only StreamFile() can open streams */
+            friend ReturnVal<FileStream, FileReadError> StreamFile(const std::filesystem::path& path, std::size_t chunkSize);
+
+            FileStream(std::intptr_t handle, std::size_t chunkSize);
+
+            /* Reads more of the file after the buffered data, returns false at the end of the file */
+            bool Fill();
+
+            /* Native file handle (file descriptor on Linux) */
+            std::intptr_t m_Handle = -1;
+
+            std::unique_ptr<char[]> m_Buffer;
+            std::size_t m_Capacity = 0;
+            std::size_t m_ChunkSize = 0;
+
+            /* The data in the buffer that has not been returned yet */
+            std::size_t m_Begin = 0;
+            std::size_t m_End = 0;
+
+            bool m_EndOfFile = false;
+            bool m_Failed = false;
+    };
+
+    /**
+     * @brief Opens a file to be read in chunks or lines with bounded memory.
+     * 
+     * @details Returns the same errors as PashaBibko::Util::ReadFile().
+     *          See PashaBibko::Util::FileStream for how to read the file.
+     * 
+     * @param path File path to read from.
+     * @param chunkSize The size of the reusable buffer and of each chunk, defaults to 1 MiB.
+     */
+    ReturnVal<FileStream, FileReadError> StreamFile(const std::filesystem::path& path, std::size_t chunkSize = 1 << 20);
+
+    #ifndef DOXYGEN_HIDE
+    namespace Internal
+    {
+        /*
+         * Vectorized functions for finding new lines, picked at runtime based on what the
+         * CPU supports (AVX2 / SSE2 / NEON) with a scalar fallback. Used for location lookups
+         * and line iteration, both only search for '\n' so other characters are ignored.
+         */
+
+        /* Returns the amount of '\n' characters in the range */
+        std::size_t CountNewLines(const char* begin, const char* end);
+
+        /* Returns the first '\n' in the range or nullptr if there is none */
+        const char* FindNewLine(const char* begin, const char* end);
+
+        /* Returns the last '\n' in the range or nullptr if there is none */
+        const char* FindLastNewLine(const char* begin, const char* end);
+
+        /* Returns the name of the kernel picked for the current CPU */
+        const char* NewLineScanKernel();
+    }
+    #endif // DOXYGEN_HIDE
+
     /**
      * @brief Location within a string.
      * 
@@ -86,4 +413,79 @@ namespace PashaBibko::Util
      *       it will return { 0, 0 } instead of a valid location.
      */
     StringLocation GetLocationAtStringIndex(const std::string& string, uint32_t index);
+
+    /**
+     * @brief Location within a string with 32-bit values.
+     * 
+     * @details Same as PashaBibko::Util::StringLocation, stored as [column, line] with
+     *          indexing based at 1, but can hold locations in files with more than
+     *          65535 lines or lines longer than 65535 characters.
+     */
+    struct TextLocation final
+    {
+        std::uint32_t column;
+        std::uint32_t line;
+    };
+
+    /**
+     * @brief Index of where each line starts within a string for fast location lookups.
+     * 
+     * @details PashaBibko::Util::GetLocationAtStringIndex() has to scan the string from the
+     *          start on every call. LineIndex scans the string once when it is created and
+     *          stores the offset of each line, so each lookup is a binary search over the lines.
+     *          Useful when finding the location of many indecies within the same string,
+     *          such as when reporting every error found in a file.
+     * 
+     *          The index does not keep a reference to the string so it can outlive it.
+     * 
+     * @code
+     * Util::LineIndex lines(source);
+     * 
+     * for (const Error& error : errors)
+     * {
+     *     Util::TextLocation location = lines.Locate(error.offset);
+     *     Util::Log(location.line, ':', location.column, ' ', error.message);
+     * }
+     * @endcode
+     */
+    class LineIndex final
+    {
+        public:
+            /**
+             * @brief Creates the index by finding every new line within the string.
+             */
+            explicit LineIndex(std::string_view string);
+
+            /**
+             * @brief Finds the location of [column, line] of a given index.
+             * 
+             * @note Matches PashaBibko::Util::GetLocationAtStringIndex(), if the index is outside
+             *       the bounds of the string it will return { 0, 0 } instead of a valid location.
+             */
+            TextLocation Locate(std::size_t index) const;
+
+            /**
+             * @brief Finds the locations of many indecies at once.
+             * 
+             * @details The indecies must be sorted in ascending order. Each lookup only
+             *          searches the lines after the previous result.
+             * 
+             * @return The location of each index, in the same order as the indecies.
+             */
+            std::vector<TextLocation> Locate(std::span<const std::size_t> sortedIndecies) const;
+
+            /**
+             * @brief Returns the amount of lines in the string, a string with no new lines has 1.
+             */
+            std::size_t LineCount() const { return m_LineStarts.size(); }
+
+            /**
+             * @brief Returns the index of the first character of the line (based at 1).
+             */
+            std::size_t LineStart(std::uint32_t line) const { return m_LineStarts[line - 1]; }
+
+        private:
+            std::vector<std::size_t> m_LineStarts;
+            std::size_t m_Length;
+    };
 }
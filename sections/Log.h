@@ -4,11 +4,22 @@
 #include <classes/Colour.h>
 #include <sections/Misc.h>
 
+#include <string_view>
 #include <type_traits>
-#include <iomanip>
+#include <algorithm>
+#include <charconv>
+#include <typeinfo>
+#include <concepts>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+#include <chrono>
+#include <atomic>
 #include <sstream>
 #include <ostream>
 #include <ranges>
+#include <string>
+#include <span>
 
 /**
  * @file Log.h
@@ -16,18 +27,85 @@
  * @brief Includes the functions for logging types to the console and log file.
  */
 
+/**
+ * @brief The lowest PashaBibko::Util::LogLevel (as an integer) that log calls are compiled for.
+ *
+ * @details Log calls below this level are removed at compile-time. When using the PBU_LOG_*
+ *          macros their arguments are not evaluated either. Defaults to 0 (LogLevel::Trace)
+ *          so every level is compiled, define it before including Util.h or pass it as a
+ *          compile definition to change it. For example `-DPBU_MIN_LOG_LEVEL=2` removes
+ *          Trace and Debug calls.
+ */
+#ifndef PBU_MIN_LOG_LEVEL
+#define PBU_MIN_LOG_LEVEL 0
+#endif // PBU_MIN_LOG_LEVEL
 
 namespace PashaBibko::Util
 {
+    /**
+     * @brief The severity of a logged message.
+     */
+    enum class LogLevel : unsigned char
+    {
+        Trace,  ///< Very detailed messages, normally only needed whilst debugging a specific area.
+        Debug,  ///< Messages that are useful whilst debugging.
+        Info,   ///< General messages, used by Util::Log().
+        Warn,   ///< Something unexpected happened but the program can continue.
+        Error,  ///< Something failed.
+        Fatal,  ///< The program cannot continue, flushes the logs after writing.
+        Off     ///< Not a message level, used as a threshold to disable all logging.
+    };
+
+    /**
+     * @brief The lowest level that is compiled in, set by PBU_MIN_LOG_LEVEL.
+     */
+    inline constexpr LogLevel CompiledLogLevel = static_cast<LogLevel>(PBU_MIN_LOG_LEVEL);
+
+    /**
+     * @brief Whether log calls of the level are compiled in.
+     */
+    template<LogLevel level>
+    inline constexpr bool LogLevelEnabled = (level >= CompiledLogLevel) && (level != LogLevel::Off);
+
     /* Excludes the internal namespace from the docs */
     #ifndef DOXYGEN_HIDE
 
     namespace Internal
     {
-        /* Functions defined in Log.cpp to allow writing to their local variables */
+        /* The runtime threshold, read with a single relaxed load on each log call */
+        inline std::atomic<LogLevel> runtimeLogLevel = LogLevel::Trace;
+
+        inline bool ShouldLog(LogLevel level)
+        {
+            return level >= runtimeLogLevel.load(std::memory_order_relaxed);
+        }
 
-        void WriteToConsole(const char* message);
-        void WriteToLog(const char* message);
+        /* The text written at the start of each message of the level */
+        constexpr std::string_view LogLevelPrefix(LogLevel level)
+        {
+            switch (level)
+            {
+                case LogLevel::Trace:   return "[PB_Util::Trace]: ";
+                case LogLevel::Debug:   return "[PB_Util::Debug]: ";
+                case LogLevel::Info:    return "[PB_Util::Info]: ";
+                case LogLevel::Warn:    return "[PB_Util::Warn]: ";
+                case LogLevel::Error:   return "[PB_Util::Error]: ";
+                case LogLevel::Fatal:   return "[PB_Util::Fatal]: ";
+                default:                return "[PB_Util::Log()]: ";
+            }
+        }
+
+        /* Where a message will be written to once it has been formatted */
+        enum class LogTarget : unsigned char
+        {
+            Console = 0b01,
+            File    = 0b10,
+            Both    = 0b11
+        };
+
+        /* Function defined in Log.cpp to allow writing to their local variables */
+        /* Either writes the message straight away or hands it to the async writer */
+        void SubmitMessage(std::string_view message, LogTarget target, Colour colour = Colour::Default, LogLevel level = LogLevel::Info);
 
         /* Checks if a type can be outputted to std::ostream */
         template<typename Ty> concept StandardLogable = requires(std::ostream & os, Ty arg)
@@ -44,27 +122,121 @@ namespace PashaBibko::Util
 	/* Helper type to display type name in static_assert() */
 	template<typename Ty> struct DependentFalse : std::false_type {};
 
+        /* Character types are written as characters instead of numbers to match std::ostream */
+        template<typename Ty> concept CharLogable =
+            std::same_as<Ty, char> || std::same_as<Ty, signed char> || std::same_as<Ty, unsigned char>;
+
+        /* Types that can be written with std::to_chars() */
+        template<typename Ty> concept NumberLogable = std::is_arithmetic_v<Ty> && !std::same_as<Ty, bool> && !CharLogable<Ty>;
+
+        /* Types that can be copied straight into the output (std::string, std::string_view and c-strings) */
+        template<typename Ty> concept StringLogable = std::is_convertible_v<const Ty&, std::string_view>;
+
+        /* The buffers that arguments can be formatted into (std::string or FixedFormatBuffer) */
+        template<typename Out> concept FormatOutput = requires(Out out, const char* str, std::size_t len, char c)
+        {
+            out.append(str, len);
+            out.push_back(c);
+        };
+
+        /* Wraps a caller provided buffer, anything that does not fit is discarded */
+        class FixedFormatBuffer final
+        {
+            public:
+                FixedFormatBuffer(char* buffer, std::size_t capacity)
+                    : m_Buffer(buffer), m_Capacity(capacity)
+                {}
+
+                void append(const char* str, std::size_t len)
+                {
+                    const std::size_t count = std::min(len, m_Capacity - m_Size);
+                    std::memcpy(m_Buffer + m_Size, str, count);
+                    m_Size += count;
+                }
+
+                void push_back(char c)
+                {
+                    if (m_Size != m_Capacity)
+                        m_Buffer[m_Size++] = c;
+                }
+
+                std::size_t size() const { return m_Size; }
+
+            private:
+                char* const m_Buffer;
+                const std::size_t m_Capacity;
+                std::size_t m_Size = 0;
+        };
+
+        /* Writes the number to the output without creating a stream, floats match the default std::ostream precision */
+        template<FormatOutput Out, typename Ty>
+        void AppendNumber(Out& out, Ty value)
+        {
+            char digits[64];
+            std::to_chars_result result;
+
+            if constexpr (std::is_floating_point_v<Ty>)
+                result = std::to_chars(digits, digits + sizeof(digits), value, std::chars_format::general, 6);
+
+            else
+                result = std::to_chars(digits, digits + sizeof(digits), value);
+
+            out.append(digits, static_cast<std::size_t>(result.ptr - digits));
+        }
+
         /* Assumes all types passed are valid as it is an internal function */
-        template<typename Ty>
-        std::string ProcessArg(Ty&& arg)
+        template<FormatOutput Out, typename Ty>
+        void AppendArg(Out& out, Ty&& arg)
         {
+            using BaseTy = std::remove_cvref_t<Ty>;
+
             /* Checks if the argument type is a pointer */
-            if constexpr(std::is_pointer_v<std::remove_cvref_t<Ty>>)
+            if constexpr(std::is_pointer_v<BaseTy>)
             {
-                /* If the pointer is valid forwards the derefenced arg */
-                if (arg != nullptr)
-                    return ProcessArg(*arg);
+                /* Prints a message about a nullptr of type Ty */
+                if (arg == nullptr)
+                {
+                    constexpr std::string_view prefix = "Nullptr of type: [";
+                    const std::string_view name = typeid(Ty).name();
 
-                /* Else prints a message about a nullptr of type Ty */
-                std::ostringstream os{};
-                os << "Nullptr of type: [" << typeid(Ty).name() << ']';
-                return std::move(os).str();
+                    out.append(prefix.data(), prefix.size());
+                    out.append(name.data(), name.size());
+                    out.push_back(']');
+                }
+
+                /* C-strings are written as strings instead of their first character */
+                else if constexpr (CharLogable<std::remove_cv_t<std::remove_pointer_t<BaseTy>>>)
+                {
+                    const std::string_view str = reinterpret_cast<const char*>(arg);
+                    out.append(str.data(), str.size());
+                }
+
+                /* If the pointer is valid forwards the derefenced arg */
+                else
+                    AppendArg(out, *arg);
             }
 
             /* Custom log function has highest precedence */
             else if constexpr (TypeHasLogFunction<Ty>)
             {
-                return arg.LogStr();
+                const std::string str = arg.LogStr();
+                out.append(str.data(), str.size());
+            }
+
+            /* Fast paths for common types that avoid creating a std::ostringstream */
+            else if constexpr (std::same_as<BaseTy, bool>)
+                out.push_back(arg ? '1' : '0');
+
+            else if constexpr (CharLogable<BaseTy>)
+                out.push_back(static_cast<char>(arg));
+
+            else if constexpr (NumberLogable<BaseTy>)
+                AppendNumber(out, arg);
+
+            else if constexpr (StringLogable<BaseTy>)
+            {
+                const std::string_view str = arg;
+                out.append(str.data(), str.size());
             }
 
             /* Checks for standard logging (std::ostream& << Ty) */
@@ -73,23 +245,65 @@ namespace PashaBibko::Util
                 std::ostringstream os{};
                 os << arg;
 
-                return std::move(os).str();
+                const std::string str = std::move(os).str();
+                out.append(str.data(), str.size());
             }
 
             /* Else returns an error */
             else
             {
-                static_assert(DependentFalse<Ty>::value, "Invalid type passed to Util::Internal::ProcessArg(), It is recommended not to use internal functions");
+                static_assert(DependentFalse<Ty>::value, "Invalid type passed to Util::Internal::AppendArg(), It is recommended not to use internal functions");
             }
         }
 
         /* Assumes all types passed are valid as it is an internal function */
-        template<typename... Args>
-        std::string ProcessArgs(Args&&... args)
+        template<FormatOutput Out, typename... Args>
+        void AppendArgs(Out& out, Args&&... args)
         {
-            return (ProcessArg(std::forward<Args>(args)) + ... + "");
+            (AppendArg(out, std::forward<Args>(args)), ...);
         }
 
+        /*
+         * Gives access to a reusable per-thread string to format messages into. Its capacity is kept
+         * between messages so formatting does not allocate once it has grown to the largest message.
+         * If a LogStr() function logs whilst the buffer is in use a temporary string is used instead.
+         */
+        class FormatBuffer final
+        {
+            public:
+                FormatBuffer()
+                    : m_Owner(!s_InUse), m_Buffer(m_Owner ? s_Buffer : m_Fallback)
+                {
+                    if (m_Owner)
+                    {
+                        s_InUse = true;
+                        if (s_Buffer.capacity() < 4096)
+                            s_Buffer.reserve(4096);
+                    }
+
+                    m_Buffer.clear();
+                }
+
+                ~FormatBuffer()
+                {
+                    if (m_Owner)
+                        s_InUse = false;
+                }
+
+                FormatBuffer(const FormatBuffer&) = delete;
+                FormatBuffer& operator=(const FormatBuffer&) = delete;
+
+                std::string& Get() { return m_Buffer; }
+
+            private:
+                static inline thread_local std::string s_Buffer;
+                static inline thread_local bool s_InUse = false;
+
+                const bool m_Owner;
+                std::string m_Fallback;
+                std::string& m_Buffer;
+        };
+
         template<typename Ty> concept LogableBase = Internal::StandardLogable<Ty> || Internal::TypeHasLogFunction<Ty>;
         template<typename Ty> concept Logable = LogableBase<Ty> || (LogableBase<std::remove_cv_t<std::remove_pointer_t<std::remove_cvref_t<Ty>>>>);
     }
@@ -128,6 +342,11 @@ namespace PashaBibko::Util
      *          }
      *          @endcode
      * 
+     *          Integers, floats, characters and strings are written directly into a reused
+     *          per-thread buffer so logging them does not allocate once the buffer has grown
+     *          to fit the message. Only types that use LogStr() or the std::ostream operator
+     *          pay for creating their own string.
+     * 
      *          Instead of adding a new line('\n') character at the end of the message
      *          you can use Util::PrintLn which will automatically apend it for you.
      * 
@@ -139,14 +358,9 @@ namespace PashaBibko::Util
         requires (Internal::Logable<std::remove_cvref_t<Args>> && ...)
     inline void Print(Args&&... args)
     {
-        if constexpr (colour != Colour::Default)
-            Util::SetConsoleColor(colour);
-
-        std::string message = Internal::ProcessArgs(std::forward<Args>(args)...);
-        Internal::WriteToConsole(message.c_str());
-
-        if constexpr (colour != Colour::Default)
-            Util::SetConsoleColor(Colour::Default);
+        Internal::FormatBuffer buffer;
+        Internal::AppendArgs(buffer.Get(), std::forward<Args>(args)...);
+        Internal::SubmitMessage(buffer.Get(), Internal::LogTarget::Console, colour);
     }
 
     /**
@@ -184,15 +398,24 @@ namespace PashaBibko::Util
      *          }
      *          @endcode
      * 
+     *          Log() messages have the LogLevel::Info level so are skipped if the level
+     *          is below the threshold, see PashaBibko::Util::SetLogLevel().
+     * 
      * @arg args The message that it will log to a file.
      */
     template<typename... Args>
         requires (Internal::Logable<std::remove_cvref_t<Args>> && ...)
     inline void Log(Args&&... args)
     {
-        std::string message = Internal::ProcessArgs("[PB_Util::Log()]: ", std::forward<Args>(args)..., '\n');
-        Internal::WriteToConsole(message.c_str());
-        Internal::WriteToLog(message.c_str());
+        if constexpr (LogLevelEnabled<LogLevel::Info>)
+        {
+            if (!Internal::ShouldLog(LogLevel::Info))
+                return;
+
+            Internal::FormatBuffer buffer;
+            Internal::AppendArgs(buffer.Get(), "[PB_Util::Log()]: ", std::forward<Args>(args)..., '\n');
+            Internal::SubmitMessage(buffer.Get(), Internal::LogTarget::Both);
+        }
     }
 
     /* These functions documentation are covered by Util::Print and Util::Log so they can be excluded */
@@ -209,25 +432,369 @@ namespace PashaBibko::Util
         requires Internal::Logable<Cargo_Ty>
     inline void Log(Ty&& name, const Container_Ty& container)
     {
+        if constexpr (!LogLevelEnabled<LogLevel::Info>)
+            return;
+
+        if (!Internal::ShouldLog(LogLevel::Info))
+            return;
+
         /* Creates a JSON like formatting of the range */
-        std::ostringstream os{};
-        os << "[PB_Util::Log]: \"" << Internal::ProcessArg(name) << "\"\n{\n";
+        Internal::FormatBuffer buffer;
+        std::string& message = buffer.Get();
+        Internal::AppendArgs(message, "[PB_Util::Log]: \"", name, "\"\n{\n");
 
         unsigned counter = 0;
         for (const auto& item : container)
         {
-            std::string itemStr = Internal::ProcessArg(item);
-            os << '\t' << std::setw(4) << std::left << counter << " | " << itemStr << '\n';
+            /* Left aligns the counter within 4 characters */
+            const std::size_t start = message.size();
+            Internal::AppendArgs(message, '\t', counter);
+            message.append(std::max<std::size_t>(start + 5, message.size()) - message.size(), ' ');
+
+            Internal::AppendArgs(message, " | ", item, '\n');
             counter++;
         }
 
-        os << "}\n";
-        std::string message = os.str();
+        message.append("}\n");
 
         /* Writes the message to console/log */
-        Internal::WriteToConsole(message.c_str());
-        Internal::WriteToLog(message.c_str());
+        Internal::SubmitMessage(message, Internal::LogTarget::Both);
     }
 
     #endif // DOXYGEN_HIDE
+
+    /**
+     * @brief Formats the arguments into a caller provided buffer without allocating.
+     *
+     * @details Uses the same rules as Util::Print() but writes to the given buffer instead
+     *          of the console. Integers and floats are written with std::to_chars() and strings
+     *          are copied as they are, so only types that rely on LogStr() or the std::ostream
+     *          operator will allocate. The output is not null-terminated.
+     *
+     * @code
+     * char buffer[128];
+     * std::size_t len = Util::FormatTo(buffer, "x=", 1, " y=", 2.5f);
+     * std::string_view message(buffer, len); // "x=1 y=2.5" //
+     * @endcode
+     *
+     * @param buffer Where the message will be written, anything that does not fit is discarded.
+     * @arg args The arguments that will be formatted.
+     *
+     * @return The amount of characters written to the buffer.
+     */
+    template<typename... Args>
+        requires (Internal::Logable<std::remove_cvref_t<Args>> && ...)
+    inline std::size_t FormatTo(std::span<char> buffer, Args&&... args)
+    {
+        Internal::FixedFormatBuffer out(buffer.data(), buffer.size());
+        Internal::AppendArgs(out, std::forward<Args>(args)...);
+        return out.size();
+    }
+
+    /**
+     * @brief What happens when a message is logged whilst the async queue is full.
+     */
+    enum class LogOverflowPolicy
+    {
+        Block,      ///< The logging thread waits until the writer has made space in the queue.
+        DropNewest, ///< The batch that is being handed over is discarded.
+        DropOldest  ///< The oldest batch in the queue is discarded to make space.
+    };
+
+    /**
+     * @brief Settings for the background log writer.
+     *
+     * @see PashaBibko::Util::EnableAsyncLogging()
+     */
+    struct AsyncLogConfig final
+    {
+        /**
+         * @brief The amount of slots in the queue, each holds one hand over from a thread.
+         *        Will be rounded up to the next power of 2.
+         *
+         * @details Without staging every message is handed over on its own so this is the
+         *          maximum amount of messages waiting to be written. With staging enabled (see
+         *          Util::SetLogFlushPolicy()) each slot holds a whole staged batch, so up to
+         *          `capacity` batches of `bufferSize` bytes can be waiting.
+         */
+        std::size_t capacity = 4096;
+
+        /**
+         * @brief The maximum amount of messages the writer will take from the
+         *        queue before flushing the console and log file.
+         */
+        std::size_t batchSize = 256;
+
+        /**
+         * @brief What to do when the queue is full.
+         */
+        LogOverflowPolicy overflow = LogOverflowPolicy::Block;
+    };
+
+    /**
+     * @brief Moves writing to the console and log file onto a background thread.
+     *
+     * @details By default every call to Util::Log() and Util::Print() writes and flushes
+     *          the message before returning. Once async logging is enabled the formatted
+     *          message is instead pushed to a bounded lock-free queue and a dedicated writer
+     *          thread drains it in batches, flushing once per batch instead of once per message.
+     *
+     *          Messages are still written in the order they were pushed to the queue.
+     *          Calling this function whilst async logging is already enabled does nothing.
+     *
+     * @code
+     * int main()
+     * {
+     *     Util::EnableAsyncLogging({ .capacity = 1 << 16, .overflow = Util::LogOverflowPolicy::DropOldest });
+     *
+     *     for (int i = 0; i < 100000; i++)
+     *         Util::Log("Iteration: ", i);
+     *
+     *     // Makes sure everything has been written before continuing //
+     *     Util::FlushLogs();
+     * }
+     * @endcode
+     *
+     * @param config The settings of the queue and writer thread.
+     */
+    void EnableAsyncLogging(const AsyncLogConfig& config = {});
+
+    /**
+     * @brief Writes all queued messages, stops the writer thread and returns to synchronous logging.
+     *
+     * @note Should not be called whilst other threads are still logging as
+     *       messages pushed during shutdown may not be written until exit.
+     */
+    void DisableAsyncLogging();
+
+    /**
+     * @brief Controls how messages are staged per thread before being written.
+     *
+     * @see PashaBibko::Util::SetLogFlushPolicy()
+     */
+    struct LogFlushPolicy final
+    {
+        /**
+         * @brief How many bytes a thread collects before handing them to the console and log.
+         *        A size of 0 disables staging so every message is handed over straight away.
+         */
+        std::size_t bufferSize = 0;
+
+        /**
+         * @brief The longest a message can be staged before it is handed over.
+         */
+        std::chrono::milliseconds interval = std::chrono::milliseconds(100);
+    };
+
+    /**
+     * @brief Sets how each thread stages its messages before they are written.
+     *
+     * @details With staging enabled each thread appends its formatted messages to its own buffer
+     *          and hands the whole buffer over once it reaches `bufferSize` bytes or its oldest
+     *          message is older than `interval`. Neighbouring messages are then written with a
+     *          single write to the console and log file so many threads logging at once become a
+     *          few large writes per interval. Messages are always written whole, so lines from
+     *          different threads never interleave, but the order between threads is only kept
+     *          per hand over.
+     *
+     *          The interval is checked each time the thread logs. If async logging is enabled
+     *          the writer thread also hands over buffers of threads that have stopped logging,
+     *          otherwise they are written by Util::FlushLogs() or when the thread exits.
+     *
+     * @code
+     * Util::SetLogFlushPolicy({ .bufferSize = 64 * 1024, .interval = std::chrono::milliseconds(50) });
+     * @endcode
+     *
+     * @param policy The new staging policy, applies to all threads.
+     */
+    void SetLogFlushPolicy(const LogFlushPolicy& policy);
+
+    /**
+     * @brief Blocks until every message logged before the call has been written and flushed.
+     *
+     * @details Intended for shutdown and crash handlers so that the queue is not lost
+     *          when the process ends. Also hands over the staged messages of every thread,
+     *          see Util::SetLogFlushPolicy().
+     */
+    void FlushLogs();
+
+    /**
+     * @brief Returns how many messages have been discarded because the async queue was full.
+     */
+    std::size_t DroppedLogCount();
+
+    /**
+     * @brief When the log file is rotated and how many old files are kept.
+     *
+     * @see PashaBibko::Util::EnableLogRotation()
+     */
+    struct LogRotationConfig final
+    {
+        /**
+         * @brief The size in bytes the log file can reach before it is rotated, 0 disables size based rotation.
+         */
+        std::uint64_t maxBytes = 64ull * 1024 * 1024;
+
+        /**
+         * @brief How long a log file is written to before it is rotated, 0 disables time based rotation.
+         */
+        std::chrono::seconds maxAge = std::chrono::seconds(0);
+
+        /**
+         * @brief How many rotated files are kept, older files are deleted. With a count of 0
+         *        the log file is deleted when it is rotated.
+         */
+        unsigned retain = 5;
+    };
+
+    /**
+     * @brief Starts rotating the log file once it is too large or too old.
+     *
+     * @details Rotated files are renamed to `<process>.log.1`, `<process>.log.2` and so on with
+     *          `.1` being the newest. A background thread opens the next file before it is needed
+     *          so rotating only swaps the file that is written to, closing and renaming the
+     *          files is done by the background thread afterwards. If the next file is not ready
+     *          yet, such as when rotating twice in quick succession, messages are written to the
+     *          current file until it is.
+     *
+     *          The limits are checked after each write so a file can go over `maxBytes` by the
+     *          size of the last write, and a file that is not written to is not rotated.
+     *
+     *          On Windows open files cannot be renamed so the file is closed, renamed and
+     *          reopened by the thread that is writing to it instead.
+     *
+     * @code
+     * Util::EnableLogRotation({ .maxBytes = 16 * 1024 * 1024, .maxAge = std::chrono::hours(24), .retain = 7 });
+     * @endcode
+     *
+     * @param config The limits of each file and how many are kept.
+     */
+    void EnableLogRotation(const LogRotationConfig& config = {});
+
+    /**
+     * @brief Stops rotating the log file, messages keep being written to the current file.
+     */
+    void DisableLogRotation();
+
+    /**
+     * @brief Sets the lowest level of messages that will be logged at runtime.
+     *
+     * @details Only applies to levels that have been compiled in, see PBU_MIN_LOG_LEVEL.
+     *          Checking the level costs a single relaxed atomic load per log call.
+     *          Setting it to LogLevel::Off disables all logging.
+     */
+    inline void SetLogLevel(LogLevel level)
+    {
+        Internal::runtimeLogLevel.store(level, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Returns the lowest level of messages that will be logged at runtime.
+     */
+    inline LogLevel GetLogLevel()
+    {
+        return Internal::runtimeLogLevel.load(std::memory_order_relaxed);
+    }
+
+    /* Excludes the internal namespace from the docs */
+    #ifndef DOXYGEN_HIDE
+
+    namespace Internal
+    {
+        /* Writes the message without checking the runtime level, used by the PBU_LOG_* macros */
+        template<LogLevel level, typename... Args>
+        inline void LogAtUnchecked(Args&&... args)
+        {
+            FormatBuffer buffer;
+            AppendArgs(buffer.Get(), LogLevelPrefix(level), std::forward<Args>(args)..., '\n');
+            SubmitMessage(buffer.Get(), LogTarget::Both, Colour::Default, level);
+
+            /* Makes sure the message is written before the program is likely to end */
+            if constexpr (level == LogLevel::Fatal)
+                FlushLogs();
+        }
+    }
+
+    #endif // DOXYGEN_HIDE
+
+    /**
+     * @brief Logs the message to the log file and console with the given level.
+     *
+     * @details Calls below PBU_MIN_LOG_LEVEL compile to nothing and calls below the runtime
+     *          level (see PashaBibko::Util::SetLogLevel()) return before formatting anything.
+     *          The arguments are still evaluated by the caller, use the PBU_LOG_* macros
+     *          if the arguments are expensive to create as they skip evaluating them as well.
+     *
+     *          Each level also has a shorthand such as Util::LogWarn() or Util::LogError().
+     *          Messages are formatted the same as PashaBibko::Util::Print() with the level
+     *          written at the start, for example `[PB_Util::Warn]: Low disk space`.
+     *
+     * @tparam level The severity of the message.
+     * @arg args The message that it will log.
+     */
+    template<LogLevel level, typename... Args>
+        requires (Internal::Logable<std::remove_cvref_t<Args>> && ...)
+    inline void LogAt(Args&&... args)
+    {
+        if constexpr (LogLevelEnabled<level>)
+        {
+            if (Internal::ShouldLog(level))
+                Internal::LogAtUnchecked<level>(std::forward<Args>(args)...);
+        }
+    }
+
+    /* Shorthands are covered by the documentation of Util::LogAt */
+    #ifndef DOXYGEN_HIDE
+
+    template<typename... Args> requires (Internal::Logable<std::remove_cvref_t<Args>> && ...)
+    inline void LogTrace(Args&&... args) { LogAt<LogLevel::Trace>(std::forward<Args>(args)...); }
+
+    template<typename... Args> requires (Internal::Logable<std::remove_cvref_t<Args>> && ...)
+    inline void LogDebug(Args&&... args) { LogAt<LogLevel::Debug>(std::forward<Args>(args)...); }
+
+    template<typename... Args> requires (Internal::Logable<std::remove_cvref_t<Args>> && ...)
+    inline void LogInfo(Args&&... args) { LogAt<LogLevel::Info>(std::forward<Args>(args)...); }
+
+    template<typename... Args> requires (Internal::Logable<std::remove_cvref_t<Args>> && ...)
+    inline void LogWarn(Args&&... args) { LogAt<LogLevel::Warn>(std::forward<Args>(args)...); }
+
+    template<typename... Args> requires (Internal::Logable<std::remove_cvref_t<Args>> && ...)
+    inline void LogError(Args&&... args) { LogAt<LogLevel::Error>(std::forward<Args>(args)...); }
+
+    template<typename... Args> requires (Internal::Logable<std::remove_cvref_t<Args>> && ...)
+    inline void LogFatal(Args&&... args) { LogAt<LogLevel::Fatal>(std::forward<Args>(args)...); }
+
+    #endif // DOXYGEN_HIDE
 }
+
+/**
+ * @brief Logs the message with the given level without evaluating the arguments if the level is disabled.
+ *
+ * @details Behaves the same as PashaBibko::Util::LogAt() except the arguments are only evaluated if
+ *          the level is compiled in and passes the runtime threshold, so it can be left in hot loops.
+ *
+ * @code
+ * PBU_LOG_DEBUG("Expensive state: ", BuildDebugString()); // BuildDebugString() is only called if Debug is enabled //
+ * @endcode
+ */
+#define PBU_LOG_AT(level, ...)                                                              \
+    do                                                                                      \
+    {                                                                                       \
+        if constexpr (::PashaBibko::Util::LogLevelEnabled<level>)                           \
+        {                                                                                   \
+            if (::PashaBibko::Util::Internal::ShouldLog(level))                             \
+                ::PashaBibko::Util::Internal::LogAtUnchecked<level>(__VA_ARGS__);           \
+        }                                                                                   \
+    } while (false)
+
+/* Shorthands are covered by the documentation of PBU_LOG_AT */
+#ifndef DOXYGEN_HIDE
+
+#define PBU_LOG_TRACE(...) PBU_LOG_AT(::PashaBibko::Util::LogLevel::Trace, __VA_ARGS__)
+#define PBU_LOG_DEBUG(...) PBU_LOG_AT(::PashaBibko::Util::LogLevel::Debug, __VA_ARGS__)
+#define PBU_LOG_INFO(...)  PBU_LOG_AT(::PashaBibko::Util::LogLevel::Info, __VA_ARGS__)
+#define PBU_LOG_WARN(...)  PBU_LOG_AT(::PashaBibko::Util::LogLevel::Warn, __VA_ARGS__)
+#define PBU_LOG_ERROR(...) PBU_LOG_AT(::PashaBibko::Util::LogLevel::Error, __VA_ARGS__)
+#define PBU_LOG_FATAL(...) PBU_LOG_AT(::PashaBibko::Util::LogLevel::Fatal, __VA_ARGS__)
+
+#endif // DOXYGEN_HIDE
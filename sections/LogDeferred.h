@@ -0,0 +1,280 @@
+#pragma once
+
+#include <sections/Log.h>
+
+#include <string_view>
+#include <type_traits>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+#include <string>
+
+/**
+ * @file LogDeferred.h
+ * 
+ * @brief Contains deferred logging, where arguments are copied on the calling thread
+ *        and turned into text later by a background thread.
+ */
+
+namespace PashaBibko::Util
+{
+    /* Excludes the internal namespace from the docs */
+    #ifndef DOXYGEN_HIDE
+
+    namespace Internal
+    {
+        /* Static description of a call site, one exists for each level and set of argument types */
+        struct DeferredFormat
+        {
+            LogLevel level;
+            void (*decode)(const std::byte* payload, std::string& out);
+        };
+
+        /* Functions defined in LogDeferred.cpp to access the calling thread's buffer */
+
+        /* Returns where the arguments should be copied to or nullptr if the message was dropped */
+        std::byte* ReserveDeferred(const DeferredFormat* format, std::size_t payloadSize);
+        void CommitDeferred();
+
+        /* Decodes everything that has been copied so far, called by Util::FlushLogs() */
+        void DrainDeferredLogs();
+
+        inline std::atomic<bool> deferredActive = false;
+
+        /* Marks arguments that are stored as a length followed by their characters */
+        struct DeferredString {};
+
+        /* Types that can be copied as their raw bytes */
+        template<typename Ty> concept DeferredValue = std::is_arithmetic_v<Ty> || std::is_enum_v<Ty>;
+
+        /*
+         * Turns an argument into what will be stored. Values and strings are kept as they are, any
+         * other type is formatted straight away as its text may depend on state that can change.
+         */
+        template<typename Ty>
+        auto DeferredCapture(Ty&& arg)
+        {
+            using BaseTy = std::remove_cvref_t<Ty>;
+
+            if constexpr (DeferredValue<BaseTy>)
+                return BaseTy(arg);
+
+            else if constexpr (StringLogable<BaseTy> && !std::is_pointer_v<BaseTy>)
+                return std::string_view(arg);
+
+            else
+            {
+                std::string text;
+                AppendArg(text, std::forward<Ty>(arg));
+                return text;
+            }
+        }
+
+        template<typename Capture>
+        using DeferredStoredT = std::conditional_t<DeferredValue<Capture>, Capture, DeferredString>;
+
+        template<typename Capture>
+        std::size_t DeferredSize(const Capture& capture)
+        {
+            if constexpr (DeferredValue<Capture>)
+                return sizeof(Capture);
+
+            else
+                return sizeof(std::uint32_t) + std::string_view(capture).size();
+        }
+
+        template<typename Capture>
+        void DeferredWrite(std::byte*& dst, const Capture& capture)
+        {
+            if constexpr (DeferredValue<Capture>)
+            {
+                std::memcpy(dst, &capture, sizeof(Capture));
+                dst += sizeof(Capture);
+            }
+
+            else
+            {
+                const std::string_view str = capture;
+                const std::uint32_t len = static_cast<std::uint32_t>(str.size());
+
+                std::memcpy(dst, &len, sizeof(len));
+                std::memcpy(dst + sizeof(len), str.data(), len);
+                dst += sizeof(len) + len;
+            }
+        }
+
+        template<typename Stored>
+        void DeferredRead(const std::byte*& src, std::string& out)
+        {
+            if constexpr (std::is_same_v<Stored, DeferredString>)
+            {
+                std::uint32_t len;
+                std::memcpy(&len, src, sizeof(len));
+
+                out.append(reinterpret_cast<const char*>(src + sizeof(len)), len);
+                src += sizeof(len) + len;
+            }
+
+            else
+            {
+                Stored value;
+                std::memcpy(&value, src, sizeof(Stored));
+
+                AppendArg(out, value);
+                src += sizeof(Stored);
+            }
+        }
+
+        /* Holds the static descriptor of a call site, its address identifies how to decode the record */
+        template<LogLevel level, typename... Stored>
+        struct DeferredFormatOf
+        {
+            static void Decode(const std::byte* payload, std::string& out)
+            {
+                const std::string_view prefix = LogLevelPrefix(level);
+                out.append(prefix.data(), prefix.size());
+
+                (DeferredRead<Stored>(payload, out), ...);
+                out.push_back('\n');
+            }
+
+            static constexpr DeferredFormat descriptor = { level, &Decode };
+        };
+
+        template<LogLevel level, typename... Captures>
+        void LogDeferredUnchecked(const Captures&... captures)
+        {
+            using Format = DeferredFormatOf<level, DeferredStoredT<Captures>...>;
+
+            const std::size_t payloadSize = (DeferredSize(captures) + ... + 0);
+            std::byte* dst = ReserveDeferred(&Format::descriptor, payloadSize);
+            if (dst == nullptr)
+                return;
+
+            (DeferredWrite(dst, captures), ...);
+            CommitDeferred();
+        }
+    }
+
+    #endif // DOXYGEN_HIDE
+
+    /**
+     * @brief Settings for deferred logging.
+     *
+     * @see PashaBibko::Util::EnableDeferredLogging()
+     */
+    struct DeferredLogConfig final
+    {
+        /**
+         * @brief The size in bytes of the buffer each logging thread copies its arguments to.
+         *        Will be rounded up to the next power of 2.
+         */
+        std::size_t bufferSize = 1 << 20;
+
+        /**
+         * @brief What to do when a thread's buffer is full. LogOverflowPolicy::DropOldest is
+         *        treated as LogOverflowPolicy::DropNewest as only the background thread can
+         *        remove messages from the buffer.
+         */
+        LogOverflowPolicy overflow = LogOverflowPolicy::DropNewest;
+
+        /**
+         * @brief How long the background thread sleeps when there is nothing to format.
+         */
+        std::chrono::microseconds pollInterval = std::chrono::microseconds(500);
+    };
+
+    /**
+     * @brief Starts the background thread that formats deferred messages.
+     *
+     * @details Once enabled Util::LogDeferred() copies the raw bytes of its arguments and a pointer
+     *          to a static descriptor of the call into a buffer owned by the calling thread. The
+     *          background thread later uses the descriptor to turn the bytes into text and passes
+     *          it on as if it had been logged with Util::LogAt(), so the flush policy and async
+     *          writer still apply.
+     *
+     *          Messages from one thread stay in order but messages from different threads are
+     *          only ordered by when the background thread reads them. Messages too large for half
+     *          of the thread's buffer are formatted by the calling thread, after the messages it
+     *          logged before them have been formatted.
+     *
+     * @param config The settings of the per-thread buffers and background thread.
+     */
+    void EnableDeferredLogging(const DeferredLogConfig& config = {});
+
+    /**
+     * @brief Formats everything that is waiting, stops the background thread and returns
+     *        Util::LogDeferred() to formatting on the calling thread.
+     */
+    void DisableDeferredLogging();
+
+    /**
+     * @brief Returns how many deferred messages have been discarded because a thread's buffer was full.
+     */
+    std::size_t DroppedDeferredLogCount();
+
+    /**
+     * @brief Logs the message with the given level, formatting it on a background thread.
+     *
+     * @details Arithmetic, enum and string arguments are copied as their raw bytes so the cost on
+     *          the calling thread is close to a memcpy of the arguments. Arguments of other types,
+     *          such as ones with a LogStr() function, are formatted straight away as their value may
+     *          change before the background thread reads them. Pointers are also formatted straight
+     *          away as the value they point to may not exist by then.
+     *
+     *          If deferred logging has not been enabled the message is logged the same as Util::LogAt().
+     *          Fatal messages are flushed straight away, also the same as Util::LogAt().
+     *
+     * @code
+     * int main()
+     * {
+     *     Util::EnableDeferredLogging();
+     *
+     *     for (int request = 0; request < 1000; request++)
+     *         Util::LogDeferred<Util::LogLevel::Trace>("Handling request ", request, " in ", 1.5, "ms");
+     *
+     *     Util::FlushLogs();
+     * }
+     * @endcode
+     *
+     * @tparam level The severity of the message.
+     * @arg args The message that it will log.
+     */
+    template<LogLevel level, typename... Args>
+        requires (Internal::Logable<std::remove_cvref_t<Args>> && ...)
+    inline void LogDeferred(Args&&... args)
+    {
+        if constexpr (LogLevelEnabled<level>)
+        {
+            if (!Internal::ShouldLog(level))
+                return;
+
+            if (!Internal::deferredActive.load(std::memory_order_relaxed))
+            {
+                Internal::LogAtUnchecked<level>(std::forward<Args>(args)...);
+                return;
+            }
+
+            Internal::LogDeferredUnchecked<level>(Internal::DeferredCapture(std::forward<Args>(args))...);
+
+            /* Makes sure the message is written before the program is likely to end */
+            if constexpr (level == LogLevel::Fatal)
+                FlushLogs();
+        }
+    }
+}
+
+/**
+ * @brief Deferred version of PBU_LOG_AT, the arguments are only evaluated if the level is enabled.
+ */
+#define PBU_LOG_DEFERRED(level, ...)                                                        \
+    do                                                                                      \
+    {                                                                                       \
+        if constexpr (::PashaBibko::Util::LogLevelEnabled<level>)                           \
+        {                                                                                   \
+            if (::PashaBibko::Util::Internal::ShouldLog(level))                             \
+                ::PashaBibko::Util::LogDeferred<level>(__VA_ARGS__);                        \
+        }                                                                                   \
+    } while (false)
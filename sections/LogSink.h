@@ -0,0 +1,297 @@
+#pragma once
+
+#include <sections/Log.h>
+
+#include <string_view>
+#include <filesystem>
+#include <functional>
+#include <cstddef>
+#include <memory>
+#include <atomic>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <span>
+
+/**
+ * @file LogSink.h
+ *
+ * @brief Contains the sinks messages are written to once they have been formatted,
+ *        such as the console and the log file.
+ */
+
+namespace PashaBibko::Util
+{
+    /**
+     * @brief A single formatted message passed to each Util::LogSink.
+     */
+    struct LogRecord final
+    {
+        std::string_view text;  ///< The message including the level prefix and the new line.
+        LogLevel level;         ///< The level the message was logged at.
+        Colour colour;          ///< The colour the message should be shown in, only used by the console.
+        bool printed;           ///< Written with Util::Print() so it is only passed to sinks that show console output.
+    };
+
+    /**
+     * @brief Changes the text of a message before it is passed to a sink, the new text is appended to `out`.
+     */
+    using LogFormatter = std::function<void(const LogRecord& record, std::string& out)>;
+
+    /**
+     * @brief Somewhere formatted messages are written to.
+     *
+     * @details Every message is formatted once and then passed to each sink whose level it is
+     *          at or above. The messages are stored in a shared reference counted buffer, so a
+     *          sink that needs the text after Write() returns can keep the buffer instead of
+     *          copying it. The buffer is only reused by the log once no sink holds it.
+     *
+     *          Write() and Flush() are only ever called by one thread at a time so sinks do not
+     *          need their own locking, unless they are read from other threads.
+     *
+     * @code
+     * class CountingSink final : public Util::LogSink
+     * {
+     *     public:
+     *         void Write(std::span<const Util::LogRecord> records, const std::shared_ptr<const std::string>&) override
+     *         {
+     *             count += records.size();
+     *         }
+     *
+     *         std::size_t count = 0;
+     * };
+     *
+     * Util::AddLogSink(std::make_shared<CountingSink>());
+     * @endcode
+     */
+    class LogSink
+    {
+        public:
+            virtual ~LogSink() = default;
+
+            /**
+             * @brief Writes the messages, the text of the records points into the buffer.
+             *
+             * @details The buffer can be null when the records are not part of a shared buffer,
+             *          such as when they are spilled from a Util::RingBufferLogSink, in which case
+             *          the text is only valid until Write() returns.
+             */
+            virtual void Write(std::span<const LogRecord> records, const std::shared_ptr<const std::string>& buffer) = 0;
+
+            /**
+             * @brief Flushes anything the sink has buffered, called by Util::FlushLogs().
+             */
+            virtual void Flush() {}
+
+            /**
+             * @brief Whether the output of Util::Print() is passed to the sink as well as logged messages.
+             */
+            virtual bool ReceivesPrinted() const { return false; }
+
+            /**
+             * @brief Sets the lowest level of messages that are passed to the sink.
+             */
+            void SetLevel(LogLevel level) { m_Level.store(level, std::memory_order_relaxed); }
+
+            /**
+             * @brief Returns the lowest level of messages that are passed to the sink.
+             */
+            LogLevel GetLevel() const { return m_Level.load(std::memory_order_relaxed); }
+
+            /**
+             * @brief Sets how messages are formatted for this sink, the messages of other sinks are not changed.
+             *
+             * @details Messages are formatted into a new buffer for each batch so sinks without a
+             *          formatter do not pay for it. Must be set before the sink is added.
+             */
+            void SetFormatter(LogFormatter formatter) { m_Formatter = std::move(formatter); }
+
+            /**
+             * @brief Returns the formatter of the sink, empty if the messages are passed as they are.
+             */
+            const LogFormatter& GetFormatter() const { return m_Formatter; }
+
+        private:
+            std::atomic<LogLevel> m_Level = LogLevel::Trace;
+            LogFormatter m_Formatter;
+    };
+
+    /**
+     * @brief Writes messages to `std::cout` in their colour, also receives the output of Util::Print().
+     */
+    class ConsoleLogSink final : public LogSink
+    {
+        public:
+            void Write(std::span<const LogRecord> records, const std::shared_ptr<const std::string>& buffer) override;
+            void Flush() override;
+            bool ReceivesPrinted() const override { return true; }
+    };
+
+    /* Excludes the internal namespace from the docs */
+    #ifndef DOXYGEN_HIDE
+
+    namespace Internal
+    {
+        /* The open file and rotation thread of a FileLogSink, defined in LogSink.cpp */
+        class RotatingFile;
+
+        /* Locks the list of sinks, held whilst any sink is written to */
+        std::unique_lock<std::mutex> LockSinks();
+
+        /* Applies the level filter and formatter of the sink then writes the records that are left */
+        void WriteToSink(LogSink& sink, std::span<const LogRecord> records, const std::shared_ptr<const std::string>& buffer);
+    }
+
+    #endif // DOXYGEN_HIDE
+
+    /**
+     * @brief Writes messages to a file, which can be rotated once it is too large or too old.
+     *
+     * @details Neighbouring messages are written with a single write and the file is flushed
+     *          after each batch. See Util::EnableLogRotation() for how rotation works, which
+     *          applies the same way to every file sink.
+     */
+    class FileLogSink : public LogSink
+    {
+        public:
+            /**
+             * @brief Opens the file, replacing its contents unless `append` is true.
+             */
+            explicit FileLogSink(const std::filesystem::path& path, bool append = false);
+            ~FileLogSink() override;
+
+            void Write(std::span<const LogRecord> records, const std::shared_ptr<const std::string>& buffer) override;
+            void Flush() override;
+
+            /**
+             * @brief Starts rotating the file once it is too large or too old.
+             */
+            void EnableRotation(const LogRotationConfig& config = {});
+
+            /**
+             * @brief Stops rotating the file, messages keep being written to the current file.
+             */
+            void DisableRotation();
+
+            /**
+             * @brief Returns the path of the file that is being written to.
+             */
+            const std::filesystem::path& Path() const;
+
+        private:
+            std::unique_ptr<Internal::RotatingFile> m_File;
+    };
+
+    /**
+     * @brief A Util::FileLogSink that starts with rotation enabled.
+     */
+    class RotatingFileLogSink final : public FileLogSink
+    {
+        public:
+            RotatingFileLogSink(const std::filesystem::path& path, const LogRotationConfig& config)
+                : FileLogSink(path)
+            {
+                EnableRotation(config);
+            }
+    };
+
+    /**
+     * @brief Keeps the most recent messages in memory so they can be written somewhere else later.
+     *
+     * @details Messages are kept by holding a reference to the shared buffer they were formatted
+     *          in, so keeping a message does not copy it. This also means a message can keep the
+     *          rest of the batch it was logged in alive until it is discarded.
+     *
+     *          Can be given a sink to spill to, which is passed every kept message once a message
+     *          at or above the trigger level is written. This allows detailed logs to only be
+     *          written to disk when something has gone wrong.
+     *
+     * @code
+     * auto memory = std::make_shared<Util::RingBufferLogSink>(4096);
+     * memory->SetSpillTarget(Util::DefaultFileSink(), Util::LogLevel::Error);
+     *
+     * Util::RemoveLogSink(Util::DefaultFileSink());
+     * Util::AddLogSink(memory);
+     * @endcode
+     */
+    class RingBufferLogSink final : public LogSink
+    {
+        public:
+            /**
+             * @brief Keeps up to `capacity` messages, the oldest are discarded first.
+             */
+            explicit RingBufferLogSink(std::size_t capacity);
+
+            void Write(std::span<const LogRecord> records, const std::shared_ptr<const std::string>& buffer) override;
+
+            /**
+             * @brief Sets where the kept messages are written when a message at or above `trigger` is written.
+             *        A null target disables spilling.
+             */
+            void SetSpillTarget(std::shared_ptr<LogSink> target, LogLevel trigger = LogLevel::Error);
+
+            /**
+             * @brief Writes every kept message to the sink and discards them.
+             */
+            void Spill(LogSink& target);
+
+            /**
+             * @brief Returns a copy of every kept message from oldest to newest.
+             */
+            std::vector<std::string> Messages() const;
+
+        private:
+            struct Entry
+            {
+                std::shared_ptr<const std::string> buffer;
+                LogRecord record;
+            };
+
+            /* Must be called whilst holding the sink lock and the ring lock */
+            void SpillLocked(LogSink& target);
+
+            mutable std::mutex m_Mutex;
+            std::vector<Entry> m_Entries;
+            std::size_t m_Next = 0;
+            std::size_t m_Count = 0;
+
+            std::shared_ptr<LogSink> m_SpillTarget;
+            LogLevel m_SpillTrigger = LogLevel::Error;
+    };
+
+    /**
+     * @brief Discards every message, useful for measuring the cost of logging without any output.
+     */
+    class NullLogSink final : public LogSink
+    {
+        public:
+            void Write(std::span<const LogRecord>, const std::shared_ptr<const std::string>&) override {}
+    };
+
+    /**
+     * @brief Adds a sink that every message at or above its level is written to.
+     *
+     * @details By default messages are written to Util::DefaultConsoleSink() and Util::DefaultFileSink().
+     */
+    void AddLogSink(std::shared_ptr<LogSink> sink);
+
+    /**
+     * @brief Stops writing messages to the sink, can be used to remove the default sinks.
+     */
+    void RemoveLogSink(const std::shared_ptr<LogSink>& sink);
+
+    /**
+     * @brief Returns every sink messages are written to.
+     */
+    std::vector<std::shared_ptr<LogSink>> GetLogSinks();
+
+    /**
+     * @brief The sink that writes to the console, added by default.
+     */
+    std::shared_ptr<ConsoleLogSink> DefaultConsoleSink();
+
+    /**
+     * @brief The sink that writes to `<process>.log`, added by default.
+     */
+    std::shared_ptr<FileLogSink> DefaultFileSink();
+}
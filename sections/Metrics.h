@@ -0,0 +1,308 @@
+#pragma once
+
+#include <string_view>
+#include <filesystem>
+#include <cstdint>
+#include <cstddef>
+#include <ostream>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <bit>
+
+/**
+ * @file Metrics.h
+ *
+ * @brief Contains counters, gauges and histograms that can be updated from hot paths
+ *        and a registry that collects them by name.
+ */
+
+namespace PashaBibko::Util
+{
+    /* Excludes the internal namespace from the docs */
+    #ifndef DOXYGEN_HIDE
+
+    namespace Internal
+    {
+        /* Each shard is on its own cache line so threads updating the same counter do not share one */
+        inline constexpr std::size_t MetricShardCount = 16;
+        inline std::atomic<std::size_t> nextMetricShard = 0;
+
+        /* Threads are spread across the shards in the order they first update a counter */
+        inline std::size_t MetricShard()
+        {
+            thread_local const std::size_t shard = nextMetricShard.fetch_add(1, std::memory_order_relaxed) % MetricShardCount;
+            return shard;
+        }
+    }
+
+    #endif // DOXYGEN_HIDE
+
+    /**
+     * @brief A value that only increases, such as the amount of bytes read.
+     *
+     * @details The count is split into shards on seperate cache lines and each thread adds to
+     *          its own shard, so adding is a single relaxed atomic add that rarely contends with
+     *          other threads. Reading the value adds the shards together.
+     */
+    class Counter final
+    {
+        public:
+            /**
+             * @brief Adds to the counter, can be called from any thread.
+             */
+            void Add(std::uint64_t amount = 1)
+            {
+                m_Shards[Internal::MetricShard()].value.fetch_add(amount, std::memory_order_relaxed);
+            }
+
+            /**
+             * @brief Returns the total of every shard. Additions made whilst reading may not be included.
+             */
+            std::uint64_t Value() const
+            {
+                std::uint64_t total = 0;
+                for (const Shard& shard : m_Shards)
+                    total += shard.value.load(std::memory_order_relaxed);
+
+                return total;
+            }
+
+        private:
+            struct alignas(64) Shard
+            {
+                std::atomic<std::uint64_t> value = 0;
+            };
+
+            Shard m_Shards[Internal::MetricShardCount];
+    };
+
+    /**
+     * @brief A value that can go up and down, such as the amount of items in a queue.
+     *
+     * @details Not sharded as setting it has to replace the value seen by every thread.
+     */
+    class Gauge final
+    {
+        public:
+            void Set(std::int64_t value) { m_Value.store(value, std::memory_order_relaxed); }
+            void Add(std::int64_t amount) { m_Value.fetch_add(amount, std::memory_order_relaxed); }
+            void Sub(std::int64_t amount) { m_Value.fetch_sub(amount, std::memory_order_relaxed); }
+
+            std::int64_t Value() const { return m_Value.load(std::memory_order_relaxed); }
+
+        private:
+            std::atomic<std::int64_t> m_Value = 0;
+    };
+
+    /**
+     * @brief The distribution of values recorded by a Util::Histogram at one point in time.
+     *
+     * @details The minimum, maximum and percentiles are the bounds of the bucket the value
+     *          fell in, so are within 1/32 (about 3%) of the recorded value.
+     */
+    struct HistogramSnapshot final
+    {
+        std::uint64_t count = 0;    ///< How many values were recorded.
+        std::uint64_t sum = 0;      ///< The total of every recorded value.
+        std::uint64_t min = 0;      ///< The smallest recorded value.
+        std::uint64_t max = 0;      ///< The largest recorded value.
+        std::uint64_t p50 = 0;      ///< Half of the values were this or less.
+        std::uint64_t p90 = 0;      ///< 90% of the values were this or less.
+        std::uint64_t p99 = 0;      ///< 99% of the values were this or less.
+        std::uint64_t p999 = 0;     ///< 99.9% of the values were this or less.
+    };
+
+    /**
+     * @brief Records the distribution of values such as latencies in nanoseconds.
+     *
+     * @details Values are counted in log-linear buckets like a HDR histogram. Each power of 2 is
+     *          split into 32 buckets so the relative error is the same for small and large values,
+     *          and every 64 bit value fits in a fixed 1920 buckets. Recording is two relaxed
+     *          atomic adds and never allocates.
+     *
+     * @code
+     * static Util::Histogram& latency = Util::Metrics::GetHistogram("server.request_ns");
+     *
+     * const auto start = std::chrono::steady_clock::now();
+     * HandleRequest();
+     * latency.Record(std::chrono::steady_clock::now() - start);
+     * @endcode
+     */
+    class Histogram final
+    {
+        public:
+            /* Only needs to be documented by the class description */
+            #ifndef DOXYGEN_HIDE
+
+            static constexpr unsigned SubBucketBits = 5;
+            static constexpr std::size_t SubBucketCount = std::size_t(1) << SubBucketBits;
+            static constexpr std::size_t BucketCount = (64 - SubBucketBits + 1) * SubBucketCount;
+
+            /* Values below SubBucketCount have a bucket each, larger ones keep their top 5 bits after the leading one */
+            static constexpr std::size_t BucketIndex(std::uint64_t value)
+            {
+                if (value < SubBucketCount)
+                    return static_cast<std::size_t>(value);
+
+                const unsigned shift = static_cast<unsigned>(std::bit_width(value)) - 1 - SubBucketBits;
+                return (shift + 1) * SubBucketCount + static_cast<std::size_t>((value >> shift) & (SubBucketCount - 1));
+            }
+
+            static constexpr std::uint64_t BucketLowest(std::size_t index)
+            {
+                if (index < SubBucketCount)
+                    return index;
+
+                const unsigned shift = static_cast<unsigned>(index / SubBucketCount) - 1;
+                return (SubBucketCount + index % SubBucketCount) << shift;
+            }
+
+            static constexpr std::uint64_t BucketHighest(std::size_t index)
+            {
+                if (index < SubBucketCount)
+                    return index;
+
+                const unsigned shift = static_cast<unsigned>(index / SubBucketCount) - 1;
+                return BucketLowest(index) + ((std::uint64_t(1) << shift) - 1);
+            }
+
+            #endif // DOXYGEN_HIDE
+
+            /**
+             * @brief Adds the value to the histogram, can be called from any thread.
+             */
+            void Record(std::uint64_t value)
+            {
+                m_Buckets[BucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+                m_Sum.fetch_add(value, std::memory_order_relaxed);
+            }
+
+            /**
+             * @brief Records the duration in nanoseconds, negative durations are recorded as 0.
+             */
+            template<typename Rep, typename Period>
+            void Record(std::chrono::duration<Rep, Period> duration)
+            {
+                const auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+                Record(nanoseconds > 0 ? static_cast<std::uint64_t>(nanoseconds) : 0);
+            }
+
+            /**
+             * @brief Reads every bucket and calculates the percentiles.
+             */
+            HistogramSnapshot Snapshot() const;
+
+        private:
+            std::atomic<std::uint64_t> m_Buckets[BucketCount] = {};
+            std::atomic<std::uint64_t> m_Sum = 0;
+    };
+
+    /**
+     * @brief The kind of metric a Util::MetricSnapshot was taken of.
+     */
+    enum class MetricType : unsigned char
+    {
+        Counter,
+        Gauge,
+        Histogram
+    };
+
+    /**
+     * @brief The value of a single metric when Util::Metrics::Snapshot() was called.
+     */
+    struct MetricSnapshot final
+    {
+        std::string name;               ///< The name the metric was registered with.
+        MetricType type;                ///< Which of value or histogram is used.
+        std::int64_t value = 0;         ///< The value of a counter or gauge.
+        HistogramSnapshot histogram;    ///< The distribution of a histogram.
+
+        /**
+         * @brief Allows snapshots to be passed to Util::Log(), including as a container.
+         */
+        std::string LogStr() const;
+    };
+
+    /* Excludes the internal namespace from the docs */
+    #ifndef DOXYGEN_HIDE
+
+    namespace Internal
+    {
+        /* Metrics updated by the library itself, registered by name in Metrics.cpp */
+        inline Counter logMessages;
+        inline Counter logBytes;
+        inline Counter fileReads;
+        inline Counter fileBytesRead;
+        inline Counter failedReturnVals;
+    }
+
+    #endif // DOXYGEN_HIDE
+
+    /**
+     * @brief Registry of every named counter, gauge and histogram.
+     *
+     * @details Metrics are created the first time their name is requested and live until the
+     *          process exits, so the returned reference can be stored and used from any thread.
+     *          Looking up a name takes a lock so hot paths should keep the reference, such as
+     *          in a static variable. Each type has its own names.
+     *
+     *          The library registers its own metrics starting with `pbu.`:
+     *          - `pbu.log.messages` and `pbu.log.bytes` for every message written by the log.
+     *          - `pbu.file.reads` and `pbu.file.bytes_read` for every successful Util::ReadFile().
+     *          - `pbu.returnval.failed` for every failed Util::ReturnVal returned by Util::ReadFile(),
+     *            Util::ReadFiles(), Util::MapFile() and Util::StreamFile(). Each failure is counted
+     *            once when it is returned to the caller, so a failed read inside Util::ReadFiles()
+     *            is counted once per file. Failures returned by user code are not counted.
+     *
+     * @code
+     * static Util::Counter& requests = Util::Metrics::GetCounter("server.requests");
+     * requests.Add();
+     *
+     * Util::Log("Metrics", Util::Metrics::Snapshot());
+     * Util::Metrics::WriteText("metrics.txt");
+     * @endcode
+     */
+    class Metrics final
+    {
+        public:
+            Metrics() = delete;
+
+            /**
+             * @brief Returns the counter with the name, creating it if it does not exist.
+             */
+            static Counter& GetCounter(std::string_view name);
+
+            /**
+             * @brief Returns the gauge with the name, creating it if it does not exist.
+             */
+            static Gauge& GetGauge(std::string_view name);
+
+            /**
+             * @brief Returns the histogram with the name, creating it if it does not exist.
+             */
+            static Histogram& GetHistogram(std::string_view name);
+
+            /**
+             * @brief Reads every metric, sorted by name.
+             */
+            static std::vector<MetricSnapshot> Snapshot();
+
+            /**
+             * @brief Writes every metric in the Prometheus text exposition format.
+             *
+             * @details Characters that are not allowed in Prometheus names, such as `.`, are
+             *          written as `_`. Histograms are written as summaries with their percentiles
+             *          as quantiles.
+             */
+            static void WriteText(std::ostream& out);
+
+            /**
+             * @brief Writes every metric to a file in the Prometheus text exposition format.
+             *
+             * @return False if the file could not be written.
+             */
+            static bool WriteText(const std::filesystem::path& path);
+    };
+}
@@ -0,0 +1,223 @@
+#pragma once
+
+#include <string_view>
+#include <filesystem>
+#include <cstdint>
+#include <ostream>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+
+/**
+ * @file Trace.h
+ *
+ * @brief Contains scoped timers that record how long named zones of code take, which can be
+ *        exported as a trace or summarised per zone.
+ */
+
+/**
+ * @brief Whether trace zones are compiled in (1) or removed (0).
+ *
+ * @details Defaults to 1 so zones can be turned on at runtime with PashaBibko::Util::StartTracing().
+ *          When set to 0 PBU_TRACE_ZONE() expands to nothing and Util::ScopedTimer does not
+ *          read the clock, define it before including Util.h or pass it as a compile definition.
+ */
+#ifndef PBU_ENABLE_TRACING
+#define PBU_ENABLE_TRACING 1
+#endif // PBU_ENABLE_TRACING
+
+namespace PashaBibko::Util
+{
+    /**
+     * @brief Whether trace zones are compiled in, set by PBU_ENABLE_TRACING.
+     */
+    inline constexpr bool TracingCompiled = (PBU_ENABLE_TRACING != 0);
+
+    /* Excludes the internal namespace from the docs */
+    #ifndef DOXYGEN_HIDE
+
+    namespace Internal
+    {
+        /* Read with a single relaxed load by each timer so disabled tracing costs a branch */
+        inline std::atomic<bool> tracingActive = false;
+
+        inline std::uint64_t TraceNow()
+        {
+            const auto now = std::chrono::steady_clock::now().time_since_epoch();
+            return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+        }
+
+        /* Appends the zone to the calling thread's buffer, defined in Trace.cpp */
+        void RecordTraceZone(const char* name, std::uint64_t start, std::uint64_t end);
+    }
+
+    #endif // DOXYGEN_HIDE
+
+    /**
+     * @brief Settings for tracing.
+     *
+     * @see PashaBibko::Util::StartTracing()
+     */
+    struct TraceConfig final
+    {
+        /**
+         * @brief The most zones each thread keeps, any more are counted by Util::DroppedTraceZoneCount().
+         *        Memory is allocated in blocks of 4096 zones as they are needed.
+         */
+        std::size_t maxZonesPerThread = 1 << 20;
+    };
+
+    /**
+     * @brief Times the scope it is created in and records it as a zone if tracing is active.
+     *
+     * @details The start and end are read from `std::chrono::steady_clock` and written to a buffer
+     *          owned by the calling thread, so recording a zone never takes a lock or waits on
+     *          another thread. If tracing was not active when the timer was created nothing is
+     *          recorded and the only cost is checking a flag.
+     *
+     *          The name is stored as a pointer so it must live until the trace is written,
+     *          string literals are recommended. Zones with the same text are summarised together.
+     *
+     * @code
+     * void Update()
+     * {
+     *     Util::ScopedTimer timer("Update");
+     *
+     *     {
+     *         PBU_TRACE_ZONE("Physics");
+     *         StepPhysics();
+     *     }
+     * }
+     * @endcode
+     */
+    class ScopedTimer final
+    {
+        public:
+            explicit ScopedTimer(const char* name)
+            {
+                if constexpr (TracingCompiled)
+                {
+                    if (Internal::tracingActive.load(std::memory_order_relaxed))
+                    {
+                        m_Name = name;
+                        m_Start = Internal::TraceNow();
+                    }
+                }
+            }
+
+            ~ScopedTimer()
+            {
+                if constexpr (TracingCompiled)
+                {
+                    if (m_Name != nullptr)
+                        Internal::RecordTraceZone(m_Name, m_Start, Internal::TraceNow());
+                }
+            }
+
+            ScopedTimer(const ScopedTimer&) = delete;
+            ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+        private:
+            const char* m_Name = nullptr;
+            std::uint64_t m_Start = 0;
+    };
+
+    /**
+     * @brief The timings of every recorded zone with the same name.
+     *
+     * @see PashaBibko::Util::TraceZoneStats()
+     */
+    struct TraceZoneSummary final
+    {
+        std::string name;                   ///< The name the zones were created with.
+        std::uint64_t count = 0;            ///< How many times the zone was recorded.
+        std::chrono::nanoseconds total{};   ///< The combined time of every recording.
+        std::chrono::nanoseconds min{};     ///< The fastest recording.
+        std::chrono::nanoseconds avg{};     ///< The mean time of a recording.
+        std::chrono::nanoseconds p99{};     ///< 99% of recordings took this long or less.
+        std::chrono::nanoseconds max{};     ///< The slowest recording.
+
+        /**
+         * @brief Allows the summary to be passed to Util::Log().
+         */
+        std::string LogStr() const;
+    };
+
+    /**
+     * @brief Starts recording zones created by Util::ScopedTimer and PBU_TRACE_ZONE().
+     *
+     * @details Zones already in the buffers are kept, use Util::ClearTrace() to remove them.
+     *          Timers created before tracing started are not recorded.
+     *
+     * @param config The settings of the per-thread buffers.
+     */
+    void StartTracing(const TraceConfig& config = {});
+
+    /**
+     * @brief Stops recording new zones, the zones recorded so far are kept until Util::ClearTrace().
+     */
+    void StopTracing();
+
+    /**
+     * @brief Removes every recorded zone and resets the dropped count.
+     *
+     * @details Must only be called when no thread can be recording a zone, for example after
+     *          Util::StopTracing() once the threads being traced have left their zones. The
+     *          buffers of threads that have exited are freed instead of being kept for reuse.
+     */
+    void ClearTrace();
+
+    /**
+     * @brief Returns how many zones have not been recorded because a thread's buffer was full.
+     */
+    std::size_t DroppedTraceZoneCount();
+
+    /**
+     * @brief Names the calling thread in the exported trace, threads without one use their index.
+     */
+    void SetTraceThreadName(std::string_view name);
+
+    /**
+     * @brief Summarises the recorded zones by name, sorted from the most to the least total time.
+     *
+     * @code
+     * for (const Util::TraceZoneSummary& zone : Util::TraceZoneStats())
+     *     Util::Log(zone);
+     * @endcode
+     */
+    std::vector<TraceZoneSummary> TraceZoneStats();
+
+    /**
+     * @brief Writes the recorded zones in the Chrome trace event JSON format.
+     *
+     * @details Each zone is a complete ("X") event with its timestamps in microseconds since
+     *          tracing started. The output can be opened in `chrome://tracing` or the Perfetto UI.
+     *
+     * @param out The stream the JSON is written to.
+     */
+    void WriteChromeTrace(std::ostream& out);
+
+    /**
+     * @brief Writes the recorded zones to a file in the Chrome trace event JSON format.
+     *
+     * @return False if the file could not be opened.
+     */
+    bool WriteChromeTrace(const std::filesystem::path& path);
+}
+
+/* Joins the line number to the name of the timer so multiple zones can be in the same scope */
+#ifndef DOXYGEN_HIDE
+#define PBU_TRACE_CONCAT_INNER(a, b) a##b
+#define PBU_TRACE_CONCAT(a, b) PBU_TRACE_CONCAT_INNER(a, b)
+#endif // DOXYGEN_HIDE
+
+/**
+ * @brief Times the rest of the current scope as a zone with the given name.
+ *        Expands to nothing if PBU_ENABLE_TRACING is 0.
+ */
+#if PBU_ENABLE_TRACING
+#define PBU_TRACE_ZONE(name) ::PashaBibko::Util::ScopedTimer PBU_TRACE_CONCAT(pbuTraceZone, __LINE__)(name)
+#else
+#define PBU_TRACE_ZONE(name) do {} while (false)
+#endif // PBU_ENABLE_TRACING
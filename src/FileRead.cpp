@@ -1,7 +1,277 @@
 #include <sections/FileRead.h>
+#include <sections/Metrics.h>
 
-#include <iostream>
-#include <fstream>
+#include <algorithm>
+#include <optional>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <atomic>
+#include <thread>
+
+/*
+ * Opening and mapping files is done with the OS functions directly as std::ifstream
+ * cannot map files and needs the output to be zero-filled before it reads into it.
+ * Each operating system has its own definitions of the functions below.
+ */
+
+namespace PashaBibko::Util::Internal
+{
+    /* A file that has been opened for reading along with its size */
+    struct OpenedFile
+    {
+        #if defined(_WIN32) || defined(_WIN64)
+            void* handle;
+        #else
+            int fd;
+        #endif
+
+        std::uint64_t size;
+    };
+
+    /*
+     * Creates the error returned by one of the public functions and counts it for the pbu.returnval.failed metric.
+     * Errors passed up from the internal functions are only counted here so each failure is counted once.
+     */
+    template<typename... Args>
+    static FunctionFail<FileReadError> ReadFailure(Args&&... args)
+    {
+        failedReturnVals.Add();
+        return FunctionFail<FileReadError>(std::forward<Args>(args)...);
+    }
+
+    /*
+     * Resizes the string and lets the operation fill it, the operation returns how many characters to keep.
+     * Uses resize_and_overwrite() (C++23) or the libstdc++ extension when available so the new characters
+     * are not zero-filled first, otherwise falls back to a normal resize.
+     */
+    template<typename String, typename Operation>
+    void ResizeAndOverwrite(String& str, std::size_t size, Operation operation)
+    {
+        if constexpr (requires { str.resize_and_overwrite(size, operation); })
+            str.resize_and_overwrite(size, operation);
+
+        else if constexpr (requires { str.__resize_and_overwrite(size, operation); })
+            str.__resize_and_overwrite(size, operation);
+
+        else
+        {
+            str.resize(size);
+            str.resize(operation(str.data(), size));
+        }
+    }
+}
+
+#if defined(_WIN32) || defined(_WIN64)
+	#ifndef NOMINMAX // Defined by GCC
+	#define NOMINMAX
+	#endif // NOMINMAX
+	#define WIN32_LEAN_AND_MEAN
+	#include <Windows.h>
+
+namespace PashaBibko::Util::Internal
+{
+    static FileReadError::Reason ReasonFromError(DWORD error)
+    {
+        switch (error)
+        {
+            case ERROR_FILE_NOT_FOUND:
+            case ERROR_PATH_NOT_FOUND:
+                return FileReadError::FileNotFound;
+
+            case ERROR_ACCESS_DENIED:
+                return FileReadError::PermissionDenied;
+
+            default:
+                return FileReadError::ReadFailed;
+        }
+    }
+
+    static ReturnVal<OpenedFile, FileReadError> OpenFile(const std::filesystem::path& path, bool sequential = false)
+    {
+        /* Folders cannot be opened with CreateFileW so they are checked for first */
+        const DWORD attributes = GetFileAttributesW(path.c_str());
+        if (attributes == INVALID_FILE_ATTRIBUTES)
+            return FunctionFail<FileReadError>(std::filesystem::absolute(path), ReasonFromError(GetLastError()));
+
+        if (attributes & FILE_ATTRIBUTE_DIRECTORY)
+            return FunctionFail<FileReadError>(std::filesystem::absolute(path), FileReadError::NotAFile);
+
+        const DWORD flags = sequential ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_ATTRIBUTE_NORMAL;
+        HANDLE handle = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, flags, nullptr);
+        if (handle == INVALID_HANDLE_VALUE)
+            return FunctionFail<FileReadError>(std::filesystem::absolute(path), ReasonFromError(GetLastError()));
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(handle, &size))
+        {
+            CloseHandle(handle);
+            return FunctionFail<FileReadError>(std::filesystem::absolute(path), FileReadError::ReadFailed);
+        }
+
+        return OpenedFile{ handle, static_cast<std::uint64_t>(size.QuadPart) };
+    }
+
+    static void CloseFile(OpenedFile& file)
+    {
+        CloseHandle(file.handle);
+    }
+
+    /* Converts to and from the handle stored by FileStream */
+    static std::intptr_t ToHandle(const OpenedFile& file) { return reinterpret_cast<std::intptr_t>(file.handle); }
+    static OpenedFile FromHandle(std::intptr_t handle) { return OpenedFile{ reinterpret_cast<void*>(handle), 0 }; }
+
+    /* Reads up to len bytes, returns how many were read or -1 on failure */
+    static std::int64_t ReadFrom(OpenedFile& file, char* dst, std::size_t len)
+    {
+        DWORD read = 0;
+        const DWORD request = static_cast<DWORD>(std::min<std::size_t>(len, 1u << 30));
+        if (!::ReadFile(file.handle, dst, request, &read, nullptr))
+            return -1;
+
+        return static_cast<std::int64_t>(read);
+    }
+
+    static const char* MapView(OpenedFile& file)
+    {
+        /* The view keeps the mapping alive so the handle can be closed straight away */
+        HANDLE mapping = CreateFileMappingW(file.handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping == nullptr)
+            return nullptr;
+
+        const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping);
+        return static_cast<const char*>(view);
+    }
+
+    static void UnmapView(const char* data, std::size_t)
+    {
+        UnmapViewOfFile(data);
+    }
+
+    static void AdviseView(const char* data, std::size_t size, MapHint hint)
+    {
+        /* Windows has no equivalent of the other hints */
+        if (hint != MapHint::WillNeed)
+            return;
+
+        WIN32_MEMORY_RANGE_ENTRY range{ const_cast<char*>(data), size };
+        PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+    }
+}
+
+#elif defined(__linux__)
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+	#include <fcntl.h>
+	#include <errno.h>
+
+namespace PashaBibko::Util::Internal
+{
+    static FileReadError::Reason ReasonFromError(int error)
+    {
+        switch (error)
+        {
+            case ENOENT:
+            case ENOTDIR:
+                return FileReadError::FileNotFound;
+
+            case EACCES:
+            case EPERM:
+                return FileReadError::PermissionDenied;
+
+            case EISDIR:
+                return FileReadError::NotAFile;
+
+            default:
+                return FileReadError::ReadFailed;
+        }
+    }
+
+    static ReturnVal<OpenedFile, FileReadError> OpenFile(const std::filesystem::path& path, bool sequential = false)
+    {
+        /*
+         * A single open() and fstat() replaces checking the path exists and is a file before opening.
+         * Opened non-blocking so FIFOs without a writer are rejected instead of blocking forever.
+         */
+        const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC | O_NONBLOCK);
+        if (fd == -1)
+            return FunctionFail<FileReadError>(std::filesystem::absolute(path), ReasonFromError(errno));
+
+        struct stat info;
+        if (fstat(fd, &info) != 0)
+        {
+            close(fd);
+            return FunctionFail<FileReadError>(std::filesystem::absolute(path), FileReadError::ReadFailed);
+        }
+
+        if (!S_ISREG(info.st_mode))
+        {
+            close(fd);
+            return FunctionFail<FileReadError>(std::filesystem::absolute(path), FileReadError::NotAFile);
+        }
+
+        /* Regular files never block but the flag is cleared so reads behave as normal */
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_NONBLOCK);
+
+        /* Lets the kernel read further ahead than normal */
+        if (sequential)
+            posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+        return OpenedFile{ fd, static_cast<std::uint64_t>(info.st_size) };
+    }
+
+    static void CloseFile(OpenedFile& file)
+    {
+        close(file.fd);
+    }
+
+    /* Converts to and from the handle stored by FileStream */
+    static std::intptr_t ToHandle(const OpenedFile& file) { return static_cast<std::intptr_t>(file.fd); }
+    static OpenedFile FromHandle(std::intptr_t handle) { return OpenedFile{ static_cast<int>(handle), 0 }; }
+
+    /* Reads up to len bytes, returns how many were read or -1 on failure */
+    static std::int64_t ReadFrom(OpenedFile& file, char* dst, std::size_t len)
+    {
+        ssize_t count;
+        do
+        {
+            count = read(file.fd, dst, len);
+        } while (count == -1 && errno == EINTR);
+
+        return static_cast<std::int64_t>(count);
+    }
+
+    static const char* MapView(OpenedFile& file)
+    {
+        void* view = mmap(nullptr, static_cast<std::size_t>(file.size), PROT_READ, MAP_PRIVATE, file.fd, 0);
+        return view == MAP_FAILED ? nullptr : static_cast<const char*>(view);
+    }
+
+    static void UnmapView(const char* data, std::size_t size)
+    {
+        munmap(const_cast<char*>(data), size);
+    }
+
+    static void AdviseView(const char* data, std::size_t size, MapHint hint)
+    {
+        int advice = MADV_NORMAL;
+        switch (hint)
+        {
+            case MapHint::Normal:       advice = MADV_NORMAL; break;
+            case MapHint::Sequential:   advice = MADV_SEQUENTIAL; break;
+            case MapHint::Random:       advice = MADV_RANDOM; break;
+            case MapHint::WillNeed:     advice = MADV_WILLNEED; break;
+        }
+
+        madvise(const_cast<char*>(data), size, advice);
+    }
+}
+
+#else
+	#error "Unsupported operating system."
+#endif
 
 namespace PashaBibko::Util
 {
@@ -9,13 +279,14 @@ namespace PashaBibko::Util
         : path(_path), reason(_reason)
     {}
 
-    const char* const FileReadError::ReasonStr(Reason reason)
+    const char* FileReadError::ReasonStr(Reason reason)
     {
         static const char* reasons[] =
         {
             "File cannot be found",
             "File reading permissions are denied",
-            "Not a file"
+            "Not a file",
+            "File could not be read"
         };
 
         return reasons[reason];
@@ -23,49 +294,380 @@ namespace PashaBibko::Util
 
     ReturnVal<std::string, FileReadError> ReadFile(const std::filesystem::path& path)
     {
-        /* Checks the file exists */
-        if (!std::filesystem::exists(path))
-            return FunctionFail<FileReadError>(std::filesystem::absolute(path), FileReadError::FileNotFound);
+        /* Opens the file, also checks it exists and is a regular file */
+        ReturnVal<Internal::OpenedFile, FileReadError> opened = Internal::OpenFile(path, true);
+        if (opened.Failed())
+            return Internal::ReadFailure(opened.Error());
 
-        /* Checks it is a regular file */
-        if (!std::filesystem::is_regular_file(path))
-            return FunctionFail<FileReadError>(std::filesystem::absolute(path), FileReadError::NotAFile);
+        Internal::OpenedFile& file = opened.Result();
+        const std::size_t len = static_cast<std::size_t>(file.size);
+
+        /* Closes the file however the function returns, including when allocating the string throws */
+        struct FileCloser
+        {
+            Internal::OpenedFile& file;
+            ~FileCloser() { Internal::CloseFile(file); }
+        } closer{ file };
+
+        /*
+         * Read instead of copied from a mapping as the file shrinking whilst it is copied (such as a log being
+         * rotated) would crash with SIGBUS, a read just ends early. Files reporting a size of 0 (such as /proc
+         * files) are read until the end.
+         */
+        std::string contents;
+        std::size_t total = 0;
+        bool failed = false;
+        bool ended = false;
+
+        do
+        {
+            /* Reads the expected size in one go, or grows 4096 characters at a time if the size is unknown */
+            const std::size_t size = len != 0 ? len : total + 4096;
+            Internal::ResizeAndOverwrite(contents, size, [&](char* data, std::size_t capacity)
+            {
+                while (total < capacity)
+                {
+                    const std::int64_t count = Internal::ReadFrom(file, data + total, capacity - total);
+                    if (count <= 0)
+                    {
+                        failed = count < 0;
+                        ended = true;
+                        break;
+                    }
 
-        /* Checks it can open the file */
-        std::ifstream file(path, std::ios::binary | std::ios::ate);
-        if (!file)
-            return FunctionFail<FileReadError>(std::filesystem::absolute(path), FileReadError::PermissionDenied);
+                    total += static_cast<std::size_t>(count);
+                }
 
-        /* Copies the file to the output string */
-        const std::streamsize len = file.tellg();
-        file.seekg(0, std::ios::beg);
+                return total;
+            });
+        } while (!ended && len == 0);
 
-        std::string contents(len, '\0');
-        file.read(&contents[0], len);
+        if (failed)
+            return Internal::ReadFailure(std::filesystem::absolute(path), FileReadError::ReadFailed);
 
+        Internal::fileReads.Add();
+        Internal::fileBytesRead.Add(contents.size());
         return contents;
     }
 
+    std::vector<ReturnVal<std::string, FileReadError>> ReadFiles(std::span<const std::filesystem::path> paths, unsigned threads)
+    {
+        if (threads == 0)
+            threads = std::max(std::thread::hardware_concurrency(), 4u);
+
+        threads = static_cast<unsigned>(std::min<std::size_t>(threads, paths.size()));
+
+        /* Each worker takes the next unread path until there are none left */
+        std::vector<std::optional<ReturnVal<std::string, FileReadError>>> slots(paths.size());
+        std::atomic<std::size_t> next = 0;
+
+        auto worker = [&]()
+        {
+            for (std::size_t index = next.fetch_add(1, std::memory_order_relaxed); index < paths.size();
+                index = next.fetch_add(1, std::memory_order_relaxed))
+            {
+                /* An exception escaping a worker thread would terminate the process so it becomes a failed read */
+                try
+                {
+                    slots[index].emplace(ReadFile(paths[index]));
+                }
+                catch (...)
+                {
+                    /* Uses the non-throwing overload so a path that cannot be made absolute does not throw again */
+                    std::error_code error;
+                    slots[index].emplace(Internal::ReadFailure(std::filesystem::absolute(paths[index], error), FileReadError::ReadFailed));
+                }
+            }
+        };
+
+        /* The calling thread is also a worker so one less thread is created */
+        std::vector<std::thread> pool;
+        if (threads > 1)
+        {
+            pool.reserve(threads - 1);
+            for (unsigned index = 1; index < threads; index++)
+                pool.emplace_back(worker);
+        }
+
+        worker();
+        for (std::thread& thread : pool)
+            thread.join();
+
+        std::vector<ReturnVal<std::string, FileReadError>> results;
+        results.reserve(paths.size());
+
+        for (std::optional<ReturnVal<std::string, FileReadError>>& slot : slots)
+            results.emplace_back(std::move(*slot));
+
+        return results;
+    }
+
+    MappedFile::~MappedFile()
+    {
+        if (m_Data != nullptr)
+            Internal::UnmapView(m_Data, m_Size);
+    }
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept
+        : m_Data(std::exchange(other.m_Data, nullptr)), m_Size(std::exchange(other.m_Size, 0))
+    {}
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+    {
+        if (this != &other)
+        {
+            if (m_Data != nullptr)
+                Internal::UnmapView(m_Data, m_Size);
+
+            m_Data = std::exchange(other.m_Data, nullptr);
+            m_Size = std::exchange(other.m_Size, 0);
+        }
+
+        return *this;
+    }
+
+    void MappedFile::Advise(MapHint hint) const
+    {
+        if (m_Data != nullptr)
+            Internal::AdviseView(m_Data, m_Size, hint);
+    }
+
+    ReturnVal<MappedFile, FileReadError> MapFile(const std::filesystem::path& path, MapHint hint)
+    {
+        ReturnVal<Internal::OpenedFile, FileReadError> opened = Internal::OpenFile(path);
+        if (opened.Failed())
+            return Internal::ReadFailure(opened.Error());
+
+        Internal::OpenedFile& file = opened.Result();
+
+        /* Empty files cannot be mapped so an empty view is returned */
+        if (file.size == 0)
+        {
+            Internal::CloseFile(file);
+            return MappedFile();
+        }
+
+        /* The mapping stays valid after the file is closed */
+        const char* view = Internal::MapView(file);
+        Internal::CloseFile(file);
+
+        if (view == nullptr)
+            return Internal::ReadFailure(std::filesystem::absolute(path), FileReadError::ReadFailed);
+
+        MappedFile mapped(view, static_cast<std::size_t>(file.size));
+        mapped.Advise(hint);
+        return mapped;
+    }
+
+    FileStream::FileStream(std::intptr_t handle, std::size_t chunkSize)
+        : m_Handle(handle), m_Buffer(std::make_unique<char[]>(chunkSize)), m_Capacity(chunkSize), m_ChunkSize(chunkSize)
+    {}
+
+    FileStream::~FileStream()
+    {
+        if (m_Handle != -1)
+        {
+            Internal::OpenedFile file = Internal::FromHandle(m_Handle);
+            Internal::CloseFile(file);
+        }
+    }
+
+    FileStream::FileStream(FileStream&& other) noexcept
+    {
+        *this = std::move(other);
+    }
+
+    FileStream& FileStream::operator=(FileStream&& other) noexcept
+    {
+        if (this != &other)
+        {
+            if (m_Handle != -1)
+            {
+                Internal::OpenedFile file = Internal::FromHandle(m_Handle);
+                Internal::CloseFile(file);
+            }
+
+            m_Handle = std::exchange(other.m_Handle, -1);
+            m_Buffer = std::move(other.m_Buffer);
+            m_Capacity = std::exchange(other.m_Capacity, 0);
+            m_ChunkSize = std::exchange(other.m_ChunkSize, 0);
+            m_Begin = std::exchange(other.m_Begin, 0);
+            m_End = std::exchange(other.m_End, 0);
+            m_EndOfFile = std::exchange(other.m_EndOfFile, true);
+            m_Failed = std::exchange(other.m_Failed, false);
+        }
+
+        return *this;
+    }
+
+    bool FileStream::Fill()
+    {
+        if (m_EndOfFile || m_Failed || m_Handle == -1)
+            return false;
+
+        /* Moves the data that has not been returned yet to the start of the buffer */
+        if (m_Begin != 0)
+        {
+            std::memmove(m_Buffer.get(), m_Buffer.get() + m_Begin, m_End - m_Begin);
+            m_End -= m_Begin;
+            m_Begin = 0;
+        }
+
+        /* Only happens when a single line is longer than the buffer */
+        if (m_End == m_Capacity)
+        {
+            auto grown = std::make_unique<char[]>(m_Capacity * 2);
+            std::memcpy(grown.get(), m_Buffer.get(), m_End);
+
+            m_Buffer = std::move(grown);
+            m_Capacity *= 2;
+        }
+
+        Internal::OpenedFile file = Internal::FromHandle(m_Handle);
+        const std::int64_t count = Internal::ReadFrom(file, m_Buffer.get() + m_End, m_Capacity - m_End);
+
+        if (count <= 0)
+        {
+            m_Failed = count < 0;
+            m_EndOfFile = true;
+            return false;
+        }
+
+        m_End += static_cast<std::size_t>(count);
+        return true;
+    }
+
+    bool FileStream::NextChunk(std::string_view& chunk)
+    {
+        /* Reads can return less than asked for so keeps reading until a full chunk is buffered */
+        while (m_End - m_Begin < m_ChunkSize && Fill());
+
+        if (m_End == m_Begin)
+            return false;
+
+        const std::size_t size = std::min(m_ChunkSize, m_End - m_Begin);
+        chunk = std::string_view(m_Buffer.get() + m_Begin, size);
+        m_Begin += size;
+        return true;
+    }
+
+    bool FileStream::NextLine(std::string_view& line)
+    {
+        /* How much of the buffered data has already been checked for a new line */
+        std::size_t searched = 0;
+
+        for (;;)
+        {
+            const char* start = m_Buffer.get() + m_Begin;
+            const std::size_t available = m_End - m_Begin;
+
+            if (const char* found = Internal::FindNewLine(start + searched, start + available))
+            {
+                const std::size_t len = static_cast<std::size_t>(found - start);
+                line = std::string_view(start, len);
+                m_Begin += len + 1;
+                return true;
+            }
+
+            searched = available;
+            if (!Fill())
+            {
+                /* The last line may not end with a new line */
+                if (m_End == m_Begin)
+                    return false;
+
+                line = std::string_view(m_Buffer.get() + m_Begin, m_End - m_Begin);
+                m_Begin = m_End;
+                return true;
+            }
+        }
+    }
+
+    ReturnVal<FileStream, FileReadError> StreamFile(const std::filesystem::path& path, std::size_t chunkSize)
+    {
+        ReturnVal<Internal::OpenedFile, FileReadError> opened = Internal::OpenFile(path, true);
+        if (opened.Failed())
+            return Internal::ReadFailure(opened.Error());
+
+        return FileStream(Internal::ToHandle(opened.Result()), std::max<std::size_t>(chunkSize, 1));
+    }
+
     StringLocation GetLocationAtStringIndex(const std::string& string, uint32_t index)
     {
-        /* Creates the output and verifies the index */
-        StringLocation location = { 1, 1 };
+        /* Verifies the index is within the string */
         if (index > string.length())
             return { 0, 0 };
 
-        /* Iterates over the string until it reaches the index */
-        for (uint32_t it = 0; it != index; it++)
+        /* The line is how many new lines come before the index and the colummn is the distance from the last one */
+        const char* const begin = string.data();
+        const char* const end = begin + index;
+
+        const char* lastNewLine = Internal::FindLastNewLine(begin, end);
+        const char* lineStart = lastNewLine != nullptr ? lastNewLine + 1 : begin;
+
+        return
+        {
+            static_cast<unsigned short>(end - lineStart + 1),
+            static_cast<unsigned short>(Internal::CountNewLines(begin, lineStart) + 1)
+        };
+    }
+
+    LineIndex::LineIndex(std::string_view string)
+        : m_Length(string.size())
+    {
+        const char* const begin = string.data();
+        const char* const end = begin + string.size();
+
+        /* Counting first is cheap compared to growing the vector multiple times */
+        m_LineStarts.reserve(Internal::CountNewLines(begin, end) + 1);
+
+        /* The first line always starts at the beginning */
+        m_LineStarts.push_back(0);
+
+        for (const char* it = begin; it != end; it++)
+        {
+            it = Internal::FindNewLine(it, end);
+            if (it == nullptr)
+                break;
+
+            m_LineStarts.push_back(static_cast<std::size_t>(it - begin) + 1);
+        }
+    }
+
+    TextLocation LineIndex::Locate(std::size_t index) const
+    {
+        if (index > m_Length)
+            return { 0, 0 };
+
+        /* Finds the last line that starts at or before the index */
+        const auto next = std::upper_bound(m_LineStarts.begin(), m_LineStarts.end(), index);
+        const std::size_t line = static_cast<std::size_t>(next - m_LineStarts.begin());
+
+        return { static_cast<std::uint32_t>(index - m_LineStarts[line - 1] + 1), static_cast<std::uint32_t>(line) };
+    }
+
+    std::vector<TextLocation> LineIndex::Locate(std::span<const std::size_t> sortedIndecies) const
+    {
+        std::vector<TextLocation> locations;
+        locations.reserve(sortedIndecies.size());
+
+        /* Each search starts from the line of the previous index as they are sorted */
+        auto current = m_LineStarts.begin();
+        for (const std::size_t index : sortedIndecies)
         {
-            /* Updates location if it reaches a new line */
-            if (string[it] == '\n')
+            if (index > m_Length)
             {
-                location.colummn = 0;
-                location.line++;
+                locations.push_back({ 0, 0 });
+                continue;
             }
 
-            location.colummn++;
+            const auto next = std::upper_bound(current, m_LineStarts.end(), index);
+            const std::size_t line = static_cast<std::size_t>(next - m_LineStarts.begin());
+            current = next - 1;
+
+            locations.push_back({ static_cast<std::uint32_t>(index - m_LineStarts[line - 1] + 1), static_cast<std::uint32_t>(line) });
         }
 
-        return location;
+        return locations;
     }
 }
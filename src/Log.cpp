@@ -1,9 +1,20 @@
+#include <sections/LogDeferred.h>
+#include <sections/LogSink.h>
+#include <sections/Metrics.h>
 #include <sections/Log.h>
 
+#include <condition_variable>
 #include <filesystem>
-#include <iostream>
-#include <fstream>
+#include <algorithm>
+#include <cstdint>
+#include <chrono>
+#include <memory>
 #include <string>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <mutex>
+#include <bit>
 
 #ifndef MAX_PATH
 #define MAX_PATH 260
@@ -36,8 +47,8 @@ namespace PashaBibko::Util::Internal
         static std::string GetProcessName()
         {
             /* Fetches the name of the process, returns "LOG" if it fails */
-            char path[MAX_PATH] = { 0 };
-            ssize_t count = readlink("/proc/self/exe", path, PATH_MAX);
+            char path[PATH_MAX] = { 0 };
+            ssize_t count = readlink("/proc/self/exe", path, sizeof(path));
             if (count == -1)
                 return "LOG";
 
@@ -48,34 +59,641 @@ namespace PashaBibko::Util::Internal
         #error "Unsupported operating system."
     #endif
 
-    /* Static initalizer for the log */
+    /* The log file is named after the process */
+    static std::filesystem::path DefaultLogPath()
+    {
+        std::filesystem::path process = GetProcessName();
+        return process.string() + ".log";
+    }
+
+    /* Every sink that messages are written to, only used whilst holding the sink lock */
+
+    static std::mutex sinkMutex;
+
+    static const std::shared_ptr<ConsoleLogSink> consoleSink = std::make_shared<ConsoleLogSink>();
+    static const std::shared_ptr<FileLogSink> fileSink = std::make_shared<FileLogSink>(DefaultLogPath());
+    static std::vector<std::shared_ptr<LogSink>> sinks = { consoleSink, fileSink };
 
-    static std::ofstream log;
+    std::unique_lock<std::mutex> LockSinks()
+    {
+        return std::unique_lock(sinkMutex);
+    }
+
+    /* Checks if a target includes the given output */
+    static constexpr bool HasTarget(LogTarget target, LogTarget output)
+    {
+        return (static_cast<unsigned char>(target) & static_cast<unsigned char>(output)) != 0;
+    }
 
-    struct LogInitalizer
+    /* A single message within a batch, the text is stored contiguously in the batch */
+    struct LogEntry
     {
-        LogInitalizer()
+        std::uint32_t length;
+        LogTarget target;
+        Colour colour;
+        LogLevel level;
+    };
+
+    /*
+     * One or more messages that are handed to the sinks together. The text is reference counted
+     * so sinks can keep it, it is only reused once no sink is holding it.
+     */
+    struct LogBatch
+    {
+        std::shared_ptr<std::string> text = std::make_shared<std::string>();
+        std::vector<LogEntry> entries;
+
+        void Append(std::string_view message, LogTarget target, Colour colour, LogLevel level)
         {
-            /* Creates the log with the name of the process */
-            std::filesystem::path process = GetProcessName();
-            std::string logPath = process.string() + ".log";
-            log.open(logPath);
+            text->append(message);
+            entries.push_back({ static_cast<std::uint32_t>(message.size()), target, colour, level });
         }
+
+        void Clear()
+        {
+            /* Keeps the capacity of both buffers so they can be reused */
+            if (text.use_count() == 1)
+                text->clear();
+
+            else
+                text = std::make_shared<std::string>();
+
+            entries.clear();
+        }
+
+        bool Empty() const { return entries.empty(); }
     };
 
-    static LogInitalizer logInitInstance;
+    /* Passes every message of the batch to each sink without copying the text, the caller must hold the sink lock */
+    static void WriteBatch(const LogBatch& batch)
+    {
+        /* Only used whilst holding the sink lock so it is reused between batches */
+        static std::vector<LogRecord> records;
+        records.clear();
+
+        std::size_t offset = 0;
+        for (const LogEntry& entry : batch.entries)
+        {
+            const bool printed = !HasTarget(entry.target, LogTarget::File);
+            records.push_back({ std::string_view(batch.text->data() + offset, entry.length), entry.level, entry.colour, printed });
+            offset += entry.length;
+        }
+
+        for (const std::shared_ptr<LogSink>& sink : sinks)
+            WriteToSink(*sink, records, batch.text);
+    }
+
+    /* Bounded multi-producer multi-consumer queue, each slot tracks which lap of the queue it is ready for */
+    class LogQueue
+    {
+        public:
+            explicit LogQueue(std::size_t capacity)
+                : m_Slots(std::make_unique<Slot[]>(capacity)), m_Mask(capacity - 1)
+            {
+                for (std::size_t index = 0; index < capacity; index++)
+                    m_Slots[index].sequence.store(index, std::memory_order_relaxed);
+            }
+
+            /*
+             * Swaps the batch into the queue if there is space, returns false if the queue is full.
+             * On success the caller is left with the empty buffers of an already written batch.
+             */
+            bool TryPush(LogBatch& batch)
+            {
+                std::size_t pos = m_EnqueuePos.load(std::memory_order_relaxed);
+                Slot* slot;
+
+                for (;;)
+                {
+                    slot = &m_Slots[pos & m_Mask];
+                    const std::size_t sequence = slot->sequence.load(std::memory_order_acquire);
+                    const std::intptr_t diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos);
+
+                    /* The slot is free for this lap so tries to claim it */
+                    if (diff == 0)
+                    {
+                        if (m_EnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                            break;
+                    }
+
+                    /* The slot still holds a batch from the last lap so the queue is full */
+                    else if (diff < 0)
+                        return false;
+
+                    /* Another producer claimed the slot first */
+                    else
+                        pos = m_EnqueuePos.load(std::memory_order_relaxed);
+                }
+
+                std::swap(slot->batch, batch);
+                slot->sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+
+            /* Swaps the oldest batch into out (which should be empty), returns false if the queue is empty */
+            bool TryPop(LogBatch& out)
+            {
+                std::size_t pos = m_DequeuePos.load(std::memory_order_relaxed);
+                Slot* slot;
+
+                for (;;)
+                {
+                    slot = &m_Slots[pos & m_Mask];
+                    const std::size_t sequence = slot->sequence.load(std::memory_order_acquire);
+                    const std::intptr_t diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos + 1);
+
+                    if (diff == 0)
+                    {
+                        if (m_DequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                            break;
+                    }
+
+                    else if (diff < 0)
+                        return false;
+
+                    else
+                        pos = m_DequeuePos.load(std::memory_order_relaxed);
+                }
+
+                std::swap(slot->batch, out);
+                slot->sequence.store(pos + m_Mask + 1, std::memory_order_release);
+                return true;
+            }
+
+            bool Empty() const
+            {
+                return m_DequeuePos.load(std::memory_order_acquire) == m_EnqueuePos.load(std::memory_order_acquire);
+            }
+
+        private:
+            /* Each slot is on its own cache line to stop producers and the writer fighting over it */
+            struct alignas(64) Slot
+            {
+                std::atomic<std::size_t> sequence;
+                LogBatch batch;
+            };
+
+            std::unique_ptr<Slot[]> m_Slots;
+            const std::size_t m_Mask;
+
+            alignas(64) std::atomic<std::size_t> m_EnqueuePos = 0;
+            alignas(64) std::atomic<std::size_t> m_DequeuePos = 0;
+    };
+
+    /* Current flush policy, stored as atomics as it is read on every log call */
+    static std::atomic<std::size_t> stagingSize = 0;
+    static std::atomic<std::int64_t> stagingInterval = std::chrono::nanoseconds(std::chrono::milliseconds(100)).count();
+
+    /* Messages a thread has logged but not yet handed to the console and log */
+    /* Declared before the async writer as the writer thread reads them until it is stopped */
+    struct ThreadLogBuffer;
+
+    static std::mutex threadBuffersMutex;
+    static std::vector<ThreadLogBuffer*> threadBuffers;
+
+    static void SweepThreadBuffers(bool onlyStale);
+    static void WriteStaleThreadBuffers();
+
+    /* Owns the queue and the background thread that drains it */
+    class AsyncLogWriter
+    {
+        public:
+            ~AsyncLogWriter()
+            {
+                /* Makes sure nothing is lost when the process exits normally */
+                Stop();
+            }
+
+            void Start(const AsyncLogConfig& config)
+            {
+                std::lock_guard lock(m_ControlMutex);
+                if (m_Thread.joinable())
+                    return;
+
+                m_Config = config;
+                m_Config.capacity = std::bit_ceil(std::max<std::size_t>(config.capacity, 2));
+                m_Config.batchSize = std::max<std::size_t>(config.batchSize, 1);
+
+                m_Queue = std::make_unique<LogQueue>(m_Config.capacity);
+                m_Running.store(true, std::memory_order_relaxed);
+                m_Thread = std::thread(&AsyncLogWriter::Run, this);
+
+                m_Active.store(true, std::memory_order_release);
+            }
+
+            void Stop()
+            {
+                std::lock_guard lock(m_ControlMutex);
+                if (!m_Thread.joinable())
+                    return;
+
+                m_Active.store(false, std::memory_order_seq_cst);
+
+                /* Waits for threads that saw the writer as active, the writer keeps running so blocked pushes can finish */
+                std::uint32_t inFlight = m_InFlight.load(std::memory_order_seq_cst);
+                while (inFlight != 0)
+                {
+                    m_InFlight.wait(inFlight, std::memory_order_seq_cst);
+                    inFlight = m_InFlight.load(std::memory_order_seq_cst);
+                }
+
+                m_Running.store(false, std::memory_order_release);
+                Wake();
+                m_Thread.join();
+
+                /* Every push has finished so nothing can be left in the queue after this */
+                Drain();
+            }
+
+            bool Active() const { return m_Active.load(std::memory_order_acquire); }
+
+            /*
+             * Pushes the batch if the writer is active, leaves the caller with an empty batch to reuse.
+             * Stop() waits for every push that saw the writer as active so none are stranded in the queue.
+             */
+            bool TryPush(LogBatch& batch)
+            {
+                m_InFlight.fetch_add(1, std::memory_order_seq_cst);
+
+                const bool active = m_Active.load(std::memory_order_seq_cst);
+                if (active)
+                    Push(batch);
+
+                /* Only wakes Stop() once it is waiting */
+                if (m_InFlight.fetch_sub(1, std::memory_order_seq_cst) == 1 && !m_Active.load(std::memory_order_seq_cst))
+                    m_InFlight.notify_all();
+
+                return active;
+            }
+
+            void Flush()
+            {
+                const std::uint64_t target = m_Pushed.load(std::memory_order_seq_cst);
+                Wake();
+
+                std::uint64_t retired = m_Retired.load(std::memory_order_acquire);
+                while (retired < target && Active())
+                {
+                    m_Retired.wait(retired, std::memory_order_acquire);
+                    retired = m_Retired.load(std::memory_order_acquire);
+                }
+            }
+
+            std::size_t Dropped() const { return m_Dropped.load(std::memory_order_relaxed); }
+
+        private:
+            void Push(LogBatch& batch)
+            {
+                const std::size_t count = batch.entries.size();
+                switch (m_Config.overflow)
+                {
+                    case LogOverflowPolicy::Block:
+                        for (;;)
+                        {
+                            /* Read before trying to push so a batch finishing in between is not missed */
+                            const std::uint32_t freed = m_SpaceFreed.load(std::memory_order_acquire);
+                            if (m_Queue->TryPush(batch))
+                                break;
+
+                            Wake();
+                            m_SpaceFreed.wait(freed, std::memory_order_acquire);
+                        }
+                        break;
+
+                    case LogOverflowPolicy::DropNewest:
+                        if (!m_Queue->TryPush(batch))
+                        {
+                            m_Dropped.fetch_add(count, std::memory_order_relaxed);
+                            batch.Clear();
+                            return;
+                        }
+                        break;
+
+                    case LogOverflowPolicy::DropOldest:
+                        while (!m_Queue->TryPush(batch))
+                        {
+                            LogBatch discarded;
+                            if (m_Queue->TryPop(discarded))
+                            {
+                                m_Dropped.fetch_add(discarded.entries.size(), std::memory_order_relaxed);
+                                Retire(discarded.entries.size());
+                            }
+                        }
+                        break;
+                }
+
+                batch.Clear();
+                m_Pushed.fetch_add(count, std::memory_order_seq_cst);
+
+                /* Only takes the lock if the writer has gone to sleep */
+                if (m_Sleeping.load(std::memory_order_seq_cst))
+                    Wake();
+            }
+
+            void Wake()
+            {
+                std::lock_guard lock(m_WakeMutex);
+                m_WakeCondition.notify_one();
+            }
+
+            void Retire(std::uint64_t count)
+            {
+                m_Retired.fetch_add(count, std::memory_order_release);
+                m_Retired.notify_all();
+            }
+
+            /* Merges up to a batch worth of messages from the queue and writes them together */
+            std::size_t WriteQueued()
+            {
+                std::size_t count = 0;
+                while (count < m_Config.batchSize)
+                {
+                    m_Incoming.Clear();
+                    if (!m_Queue->TryPop(m_Incoming))
+                        break;
+
+                    m_Merged.text->append(*m_Incoming.text);
+                    m_Merged.entries.insert(m_Merged.entries.end(), m_Incoming.entries.begin(), m_Incoming.entries.end());
+                    count += m_Incoming.entries.size();
+                }
+
+                if (count != 0)
+                {
+                    {
+                        std::lock_guard lock(sinkMutex);
+                        WriteBatch(m_Merged);
+                    }
+
+                    m_Merged.Clear();
+                    m_SpaceFreed.fetch_add(1, std::memory_order_release);
+                    m_SpaceFreed.notify_all();
+                    Retire(count);
+                }
+
+                return count;
+            }
+
+            void Drain()
+            {
+                while (WriteQueued() != 0);
+            }
+
+            void Run()
+            {
+                while (m_Running.load(std::memory_order_acquire))
+                {
+                    if (WriteQueued() != 0)
+                        continue;
+
+                    /* Writes messages staged by threads that have stopped logging */
+                    WriteStaleThreadBuffers();
+
+                    /* Announces it is going to sleep then checks again so a push in between is not missed */
+                    std::unique_lock lock(m_WakeMutex);
+                    m_Sleeping.store(true, std::memory_order_seq_cst);
+
+                    if (m_Queue->Empty() && m_Running.load(std::memory_order_acquire))
+                        m_WakeCondition.wait_for(lock, std::chrono::milliseconds(10));
+
+                    m_Sleeping.store(false, std::memory_order_relaxed);
+                }
+
+                Drain();
+            }
+
+            AsyncLogConfig m_Config;
+            std::unique_ptr<LogQueue> m_Queue;
+
+            /* Only used by the writer thread, kept to reuse their buffers */
+            LogBatch m_Incoming;
+            LogBatch m_Merged;
 
-    /* External functions to allow Log.h to write to the console and log */
+            std::thread m_Thread;
+            std::mutex m_ControlMutex;
+
+            std::mutex m_WakeMutex;
+            std::condition_variable m_WakeCondition;
+
+            std::atomic<bool> m_Active = false;
+            std::atomic<bool> m_Running = false;
+            std::atomic<bool> m_Sleeping = false;
+
+            std::atomic<std::uint32_t> m_InFlight = 0;
+            std::atomic<std::uint64_t> m_Pushed = 0;
+            std::atomic<std::uint64_t> m_Retired = 0;
+            std::atomic<std::uint32_t> m_SpaceFreed = 0;
+            std::atomic<std::size_t> m_Dropped = 0;
+    };
+
+    /* Declared after the log so it is destroyed (and drained) before the log is closed */
+    static AsyncLogWriter asyncWriter;
+
+    /* Gives a batch to the async writer if it is running, otherwise writes it straight away */
+    static void HandOff(LogBatch& batch)
+    {
+        if (batch.Empty())
+            return;
+
+        if (asyncWriter.TryPush(batch))
+            return;
+
+        std::lock_guard lock(sinkMutex);
+        WriteBatch(batch);
+        batch.Clear();
+    }
+
+    struct ThreadLogBuffer
+    {
+        ThreadLogBuffer()
+        {
+            std::lock_guard lock(threadBuffersMutex);
+            threadBuffers.push_back(this);
+        }
+
+        ~ThreadLogBuffer()
+        {
+            {
+                std::lock_guard lock(threadBuffersMutex);
+                std::erase(threadBuffers, this);
+            }
+
+            /* Anything left over is written as the thread exits */
+            std::lock_guard lock(mutex);
+            HandOff(batch);
+        }
+
+        bool Stale(std::chrono::steady_clock::time_point now) const
+        {
+            return !batch.Empty() && (now - firstMessage).count() >= stagingInterval.load(std::memory_order_relaxed);
+        }
+
+        /* Only contended when another thread is flushing all of the buffers */
+        std::mutex mutex;
+        LogBatch batch;
+        std::chrono::steady_clock::time_point firstMessage;
+    };
+
+    static void SweepThreadBuffers(bool onlyStale)
+    {
+        const auto now = std::chrono::steady_clock::now();
+        std::lock_guard lock(threadBuffersMutex);
+
+        for (ThreadLogBuffer* buffer : threadBuffers)
+        {
+            std::lock_guard bufferLock(buffer->mutex);
+            if (!onlyStale || buffer->Stale(now))
+                HandOff(buffer->batch);
+        }
+    }
+
+    /*
+     * Called by the writer thread, writes directly instead of pushing to its own queue.
+     * Never blocks on a thread that is logging as that thread could be waiting for the writer.
+     */
+    static void WriteStaleThreadBuffers()
+    {
+        const auto now = std::chrono::steady_clock::now();
+        std::unique_lock lock(threadBuffersMutex, std::try_to_lock);
+        if (!lock.owns_lock())
+            return;
+
+        for (ThreadLogBuffer* buffer : threadBuffers)
+        {
+            std::unique_lock bufferLock(buffer->mutex, std::try_to_lock);
+            if (!bufferLock.owns_lock() || !buffer->Stale(now))
+                continue;
+
+            std::lock_guard sinkLock(sinkMutex);
+            WriteBatch(buffer->batch);
+            buffer->batch.Clear();
+        }
+    }
+
+    /* External function to allow Log.h to write to the console and log */
+
+    void SubmitMessage(std::string_view message, LogTarget target, Colour colour, LogLevel level)
+    {
+        logMessages.Add();
+        logBytes.Add(message.size());
+
+        const std::size_t limit = stagingSize.load(std::memory_order_relaxed);
+
+        /* Without staging each message is its own batch, reused to avoid reallocating */
+        if (limit == 0)
+        {
+            thread_local LogBatch single;
+            single.Append(message, target, colour, level);
+            HandOff(single);
+            return;
+        }
+
+        thread_local ThreadLogBuffer buffer;
+        std::lock_guard lock(buffer.mutex);
+
+        const auto now = std::chrono::steady_clock::now();
+        if (buffer.batch.Empty())
+            buffer.firstMessage = now;
+
+        buffer.batch.Append(message, target, colour, level);
+
+        /* Hands the buffer over when it is full or the oldest message has waited long enough */
+        if (buffer.batch.text->size() >= limit || buffer.Stale(now))
+            HandOff(buffer.batch);
+    }
+
+    /* Declared last so it is destroyed first, stops deferred logging whilst the writers it uses are still alive */
+    struct LogShutdown
+    {
+        ~LogShutdown()
+        {
+            DisableDeferredLogging();
+        }
+    };
+
+    static LogShutdown logShutdownInstance;
+}
+
+namespace PashaBibko::Util
+{
+    void EnableAsyncLogging(const AsyncLogConfig& config)
+    {
+        Internal::asyncWriter.Start(config);
+    }
+
+    void DisableAsyncLogging()
+    {
+        Internal::asyncWriter.Stop();
+    }
+
+    void SetLogFlushPolicy(const LogFlushPolicy& policy)
+    {
+        Internal::stagingInterval.store(std::chrono::nanoseconds(policy.interval).count(), std::memory_order_relaxed);
+        Internal::stagingSize.store(policy.bufferSize, std::memory_order_relaxed);
+
+        /* Messages staged under the old policy should not wait for the new one */
+        if (policy.bufferSize == 0)
+            Internal::SweepThreadBuffers(false);
+    }
+
+    void FlushLogs()
+    {
+        Internal::DrainDeferredLogs();
+        Internal::SweepThreadBuffers(false);
+        Internal::asyncWriter.Flush();
+
+        std::lock_guard lock(Internal::sinkMutex);
+        for (const std::shared_ptr<LogSink>& sink : Internal::sinks)
+            sink->Flush();
+    }
+
+    std::size_t DroppedLogCount()
+    {
+        return Internal::asyncWriter.Dropped();
+    }
+
+    void EnableLogRotation(const LogRotationConfig& config)
+    {
+        Internal::fileSink->EnableRotation(config);
+    }
+
+    void DisableLogRotation()
+    {
+        Internal::fileSink->DisableRotation();
+    }
+
+    void AddLogSink(std::shared_ptr<LogSink> sink)
+    {
+        std::lock_guard lock(Internal::sinkMutex);
+        Internal::sinks.push_back(std::move(sink));
+    }
+
+    void RemoveLogSink(const std::shared_ptr<LogSink>& sink)
+    {
+        /* Released after unlocking so a sink is never destroyed whilst the lock is held */
+        std::shared_ptr<LogSink> removed;
+
+        std::lock_guard lock(Internal::sinkMutex);
+        auto it = std::find(Internal::sinks.begin(), Internal::sinks.end(), sink);
+        if (it == Internal::sinks.end())
+            return;
+
+        removed = std::move(*it);
+        Internal::sinks.erase(it);
+    }
+
+    std::vector<std::shared_ptr<LogSink>> GetLogSinks()
+    {
+        std::lock_guard lock(Internal::sinkMutex);
+        return Internal::sinks;
+    }
 
-    void WriteToConsole(const char* message)
+    std::shared_ptr<ConsoleLogSink> DefaultConsoleSink()
     {
-        std::cout << message;
-        std::cout.flush();
+        return Internal::consoleSink;
     }
 
-    void WriteToLog(const char* message)
+    std::shared_ptr<FileLogSink> DefaultFileSink()
     {
-        log << message;
-        log.flush();
+        return Internal::fileSink;
     }
 }
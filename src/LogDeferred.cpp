@@ -0,0 +1,353 @@
+#include <sections/LogDeferred.h>
+
+#include <condition_variable>
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <mutex>
+#include <bit>
+
+namespace PashaBibko::Util::Internal
+{
+    /* Written before the arguments of each message, records are kept 16 byte aligned so a header always fits */
+    struct alignas(16) DeferredHeader
+    {
+        /* nullptr marks padding at the end of the buffer that should be skipped */
+        const DeferredFormat* format;
+        std::uint32_t size;
+    };
+
+    static_assert(sizeof(DeferredHeader) == 16, "Deferred records expect a 16 byte header");
+
+    static constexpr std::size_t RecordSize(std::size_t payloadSize)
+    {
+        return (sizeof(DeferredHeader) + payloadSize + 15) & ~std::size_t(15);
+    }
+
+    /* Single producer (the logging thread) single consumer (whoever holds the decode lock) byte buffer */
+    class DeferredRing
+    {
+        public:
+            explicit DeferredRing(std::size_t capacity)
+                : m_Data(std::make_unique<Storage[]>(capacity / sizeof(Storage))), m_Capacity(capacity)
+            {}
+
+            /* Returns where the record should be written or nullptr if there is not enough space */
+            std::byte* TryReserve(std::size_t size)
+            {
+                const std::size_t offset = m_WriteHead & (m_Capacity - 1);
+                const std::size_t padding = (offset + size > m_Capacity) ? (m_Capacity - offset) : 0;
+
+                /* Only re-reads the position of the reader when the cached one says it is full */
+                if (m_WriteHead + padding + size - m_CachedTail > m_Capacity)
+                {
+                    m_CachedTail = m_Tail.load(std::memory_order_acquire);
+                    if (m_WriteHead + padding + size - m_CachedTail > m_Capacity)
+                        return nullptr;
+                }
+
+                /* Records are never split across the end so the rest of the buffer is skipped */
+                if (padding != 0)
+                {
+                    DeferredHeader skip{ nullptr, static_cast<std::uint32_t>(padding) };
+                    std::memcpy(Bytes() + offset, &skip, sizeof(skip));
+
+                    m_WriteHead += padding;
+                    m_PublishedHead.store(m_WriteHead, std::memory_order_release);
+                }
+
+                m_Reserved = size;
+                return Bytes() + (m_WriteHead & (m_Capacity - 1));
+            }
+
+            void Commit()
+            {
+                m_WriteHead += m_Reserved;
+                m_PublishedHead.store(m_WriteHead, std::memory_order_release);
+            }
+
+            /* Calls the function with each record written so far, must only be called with the decode lock held */
+            template<typename Func>
+            std::size_t Consume(Func&& func)
+            {
+                const std::size_t head = m_PublishedHead.load(std::memory_order_acquire);
+                std::size_t tail = m_Tail.load(std::memory_order_relaxed);
+                std::size_t count = 0;
+
+                while (tail != head)
+                {
+                    const std::byte* record = Bytes() + (tail & (m_Capacity - 1));
+
+                    DeferredHeader header;
+                    std::memcpy(&header, record, sizeof(header));
+
+                    if (header.format != nullptr)
+                    {
+                        func(*header.format, record + sizeof(DeferredHeader));
+                        count++;
+                    }
+
+                    tail += header.size;
+                }
+
+                m_Tail.store(tail, std::memory_order_release);
+                return count;
+            }
+
+            bool Empty() const
+            {
+                return m_PublishedHead.load(std::memory_order_acquire) == m_Tail.load(std::memory_order_acquire);
+            }
+
+            std::size_t Capacity() const { return m_Capacity; }
+
+            /* Set when the owning thread exits so the reader can free the buffer once it is empty */
+            std::atomic<bool> closed = false;
+
+        private:
+            struct alignas(16) Storage { std::byte bytes[16]; };
+
+            std::byte* Bytes() { return reinterpret_cast<std::byte*>(m_Data.get()); }
+
+            std::unique_ptr<Storage[]> m_Data;
+            const std::size_t m_Capacity;
+
+            /* Only used by the writing thread */
+            std::size_t m_WriteHead = 0;
+            std::size_t m_CachedTail = 0;
+            std::size_t m_Reserved = 0;
+
+            /* Shared between the two threads, kept on seperate cache lines */
+            alignas(64) std::atomic<std::size_t> m_PublishedHead = 0;
+            alignas(64) std::atomic<std::size_t> m_Tail = 0;
+    };
+
+    /* Owns the per-thread buffers and the thread that formats them */
+    class DeferredLogger
+    {
+        public:
+            void Start(const DeferredLogConfig& config)
+            {
+                std::lock_guard lock(m_ControlMutex);
+                if (m_Thread.joinable())
+                    return;
+
+                m_Config = config;
+                m_Config.bufferSize = std::bit_ceil(std::max<std::size_t>(config.bufferSize, 4096));
+
+                m_Running.store(true, std::memory_order_relaxed);
+                m_Thread = std::thread(&DeferredLogger::Run, this);
+                deferredActive.store(true, std::memory_order_release);
+            }
+
+            void Stop()
+            {
+                std::lock_guard lock(m_ControlMutex);
+                if (!m_Thread.joinable())
+                    return;
+
+                deferredActive.store(false, std::memory_order_release);
+                {
+                    std::lock_guard wakeLock(m_WakeMutex);
+                    m_Running.store(false, std::memory_order_release);
+                }
+
+                m_WakeCondition.notify_one();
+                m_Thread.join();
+
+                /* Formats anything written by threads that raced with the shutdown */
+                Drain();
+            }
+
+            std::shared_ptr<DeferredRing> CreateRing()
+            {
+                auto ring = std::make_shared<DeferredRing>(m_Config.bufferSize);
+
+                std::lock_guard lock(m_RingsMutex);
+                m_Rings.push_back(ring);
+                return ring;
+            }
+
+            /* Formats every record that has been committed so far, returns how many were formatted */
+            std::size_t Drain()
+            {
+                std::lock_guard lock(m_DecodeMutex);
+
+                /* Copies the list so threads can register whilst formatting */
+                {
+                    std::lock_guard ringsLock(m_RingsMutex);
+                    m_Snapshot = m_Rings;
+                }
+
+                std::size_t count = 0;
+                for (const std::shared_ptr<DeferredRing>& ring : m_Snapshot)
+                {
+                    count += ring->Consume([this](const DeferredFormat& format, const std::byte* payload)
+                    {
+                        m_Text.clear();
+                        format.decode(payload, m_Text);
+                        SubmitMessage(m_Text, LogTarget::Both, Colour::Default, format.level);
+                    });
+                }
+
+                /* Buffers of threads that have exited are freed once everything in them is formatted */
+                {
+                    std::lock_guard ringsLock(m_RingsMutex);
+                    std::erase_if(m_Rings, [](const std::shared_ptr<DeferredRing>& ring)
+                    {
+                        return ring->closed.load(std::memory_order_acquire) && ring->Empty();
+                    });
+                }
+
+                m_Snapshot.clear();
+                return count;
+            }
+
+            const DeferredLogConfig& Config() const { return m_Config; }
+
+            std::atomic<std::size_t> dropped = 0;
+
+        private:
+            void Run()
+            {
+                while (m_Running.load(std::memory_order_acquire))
+                {
+                    if (Drain() != 0)
+                        continue;
+
+                    /* Logging threads never wake the formatter so it polls whilst idle */
+                    std::unique_lock lock(m_WakeMutex);
+                    m_WakeCondition.wait_for(lock, m_Config.pollInterval, [this]()
+                    {
+                        return !m_Running.load(std::memory_order_acquire);
+                    });
+                }
+
+                Drain();
+            }
+
+            DeferredLogConfig m_Config;
+
+            std::mutex m_RingsMutex;
+            std::vector<std::shared_ptr<DeferredRing>> m_Rings;
+
+            /* Only used whilst holding the decode lock */
+            std::mutex m_DecodeMutex;
+            std::vector<std::shared_ptr<DeferredRing>> m_Snapshot;
+            std::string m_Text;
+
+            std::thread m_Thread;
+            std::mutex m_ControlMutex;
+
+            std::mutex m_WakeMutex;
+            std::condition_variable m_WakeCondition;
+            std::atomic<bool> m_Running = false;
+    };
+
+    /*
+     * Never destroyed as it can be used by other static objects during exit. The
+     * thread is stopped by the log before it closes, see LogShutdown in Log.cpp.
+     */
+    static DeferredLogger& Logger()
+    {
+        static DeferredLogger* logger = new DeferredLogger();
+        return *logger;
+    }
+
+    /* The calling thread's buffer, created the first time it logs a deferred message */
+    struct ThreadDeferredRing
+    {
+        ~ThreadDeferredRing()
+        {
+            if (ring != nullptr)
+                ring->closed.store(true, std::memory_order_release);
+        }
+
+        std::shared_ptr<DeferredRing> ring;
+
+        /* Used for records that can never fit in the buffer */
+        std::unique_ptr<std::byte[]> oversized;
+        const DeferredFormat* oversizedFormat = nullptr;
+    };
+
+    static thread_local ThreadDeferredRing threadRing;
+
+    std::byte* ReserveDeferred(const DeferredFormat* format, std::size_t payloadSize)
+    {
+        DeferredLogger& logger = Logger();
+        if (threadRing.ring == nullptr)
+            threadRing.ring = logger.CreateRing();
+
+        DeferredRing& ring = *threadRing.ring;
+        const std::size_t size = RecordSize(payloadSize);
+
+        /* Messages that could never fit are formatted by the calling thread when they are committed */
+        if (size > ring.Capacity() / 2)
+        {
+            threadRing.oversized = std::make_unique<std::byte[]>(payloadSize);
+            threadRing.oversizedFormat = format;
+            return threadRing.oversized.get();
+        }
+
+        std::byte* record = ring.TryReserve(size);
+        while (record == nullptr)
+        {
+            /* Also gives up if the formatter has been stopped as nothing will make space */
+            if (logger.Config().overflow != LogOverflowPolicy::Block || !deferredActive.load(std::memory_order_relaxed))
+            {
+                logger.dropped.fetch_add(1, std::memory_order_relaxed);
+                return nullptr;
+            }
+
+            std::this_thread::yield();
+            record = ring.TryReserve(size);
+        }
+
+        const DeferredHeader header{ format, static_cast<std::uint32_t>(size) };
+        std::memcpy(record, &header, sizeof(header));
+        return record + sizeof(DeferredHeader);
+    }
+
+    void CommitDeferred()
+    {
+        if (threadRing.oversizedFormat != nullptr)
+        {
+            /* Formats the earlier messages of the thread first so the oversized one does not overtake them */
+            Logger().Drain();
+
+            std::string text;
+            threadRing.oversizedFormat->decode(threadRing.oversized.get(), text);
+            SubmitMessage(text, LogTarget::Both, Colour::Default, threadRing.oversizedFormat->level);
+
+            threadRing.oversized.reset();
+            threadRing.oversizedFormat = nullptr;
+            return;
+        }
+
+        threadRing.ring->Commit();
+    }
+
+    void DrainDeferredLogs()
+    {
+        Logger().Drain();
+    }
+}
+
+namespace PashaBibko::Util
+{
+    void EnableDeferredLogging(const DeferredLogConfig& config)
+    {
+        Internal::Logger().Start(config);
+    }
+
+    void DisableDeferredLogging()
+    {
+        Internal::Logger().Stop();
+    }
+
+    std::size_t DroppedDeferredLogCount()
+    {
+        return Internal::Logger().dropped.load(std::memory_order_relaxed);
+    }
+}
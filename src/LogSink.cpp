@@ -0,0 +1,461 @@
+#include <sections/LogSink.h>
+
+#include <condition_variable>
+#include <algorithm>
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <thread>
+
+namespace PashaBibko::Util::Internal
+{
+    /* Where the log file is rotated to, index 1 is the newest */
+    static std::filesystem::path RotatedPath(const std::filesystem::path& path, unsigned index)
+    {
+        std::filesystem::path rotated = path;
+        rotated += '.';
+        rotated += std::to_string(index);
+        return rotated;
+    }
+
+    /* Moves each kept file up by one, deleting the oldest, then moves the log file to index 1 */
+    static void ShiftRotatedFiles(const std::filesystem::path& path, unsigned retain)
+    {
+        /* Failures are ignored as there is nowhere to report them, the log keeps being written either way */
+        std::error_code error;
+        if (retain == 0)
+        {
+            std::filesystem::remove(path, error);
+            return;
+        }
+
+        std::filesystem::remove(RotatedPath(path, retain), error);
+        for (unsigned index = retain - 1; index >= 1; index--)
+            std::filesystem::rename(RotatedPath(path, index), RotatedPath(path, index + 1), error);
+
+        std::filesystem::rename(path, RotatedPath(path, 1), error);
+    }
+
+    /*
+     * An open log file. Rotating swaps in a file the rotation thread opened beforehand (named
+     * <path>.next) so the writing thread never waits on the disk, the rotation thread then
+     * closes the old file and renames the files in the background.
+     */
+    class RotatingFile
+    {
+        public:
+            RotatingFile(const std::filesystem::path& path, bool append)
+                : m_Path(path), m_Current(std::make_unique<std::ofstream>(path, append ? std::ios::app : std::ios::trunc)),
+                  m_OpenedAt(std::chrono::steady_clock::now())
+            {}
+
+            ~RotatingFile()
+            {
+                DisableRotation();
+            }
+
+            /* Writing, flushing and rotating must be done whilst holding the sink lock */
+
+            void Write(std::string_view message)
+            {
+                m_Current->write(message.data(), message.size());
+                m_Written += message.size();
+            }
+
+            void Flush()
+            {
+                m_Current->flush();
+            }
+
+            void RotateIfNeeded()
+            {
+                if (!m_Rotating.load(std::memory_order_relaxed))
+                    return;
+
+                const auto now = std::chrono::steady_clock::now();
+                const bool tooLarge = m_Config.maxBytes != 0 && m_Written >= m_Config.maxBytes;
+                const bool tooOld = m_Config.maxAge.count() != 0 && now - m_OpenedAt >= m_Config.maxAge;
+
+                if (!tooLarge && !tooOld)
+                    return;
+
+                #if defined(_WIN32) || defined(_WIN64)
+                    /* Open files cannot be renamed on Windows so it is done by the writing thread */
+                    m_Current->close();
+                    ShiftRotatedFiles(m_Path, m_Config.retain);
+                    m_Current->open(m_Path, std::ios::trunc);
+
+                #else
+                    /* Never waits on the rotation thread, keeps writing to the current file until the next one is ready */
+                    std::unique_lock lock(m_RotateMutex, std::try_to_lock);
+                    if (!lock.owns_lock() || m_Next == nullptr || m_Retired != nullptr)
+                        return;
+
+                    m_Retired = std::move(m_Current);
+                    m_Current = std::move(m_Next);
+
+                    lock.unlock();
+                    m_RotateCondition.notify_one();
+
+                #endif
+
+                m_Written = 0;
+                m_OpenedAt = now;
+            }
+
+            /* Called whilst holding the sink lock so the config is not changed mid rotation */
+            void EnableRotation(const LogRotationConfig& config)
+            {
+                {
+                    /* Also read by the rotation thread whilst holding the rotate lock */
+                    std::lock_guard rotateLock(m_RotateMutex);
+                    m_Config = config;
+                }
+
+                m_Rotating.store(true, std::memory_order_relaxed);
+
+                #if !defined(_WIN32) && !defined(_WIN64)
+                    std::lock_guard lock(m_ControlMutex);
+                    if (m_Thread.joinable())
+                        return;
+
+                    m_Running = true;
+                    m_Thread = std::thread(&RotatingFile::RunRotation, this);
+                #endif
+            }
+
+            void DisableRotation()
+            {
+                m_Rotating.store(false, std::memory_order_relaxed);
+
+                #if !defined(_WIN32) && !defined(_WIN64)
+                    std::lock_guard lock(m_ControlMutex);
+                    if (!m_Thread.joinable())
+                        return;
+
+                    {
+                        std::lock_guard rotateLock(m_RotateMutex);
+                        m_Running = false;
+                    }
+
+                    m_RotateCondition.notify_one();
+                    m_Thread.join();
+                #endif
+            }
+
+            const std::filesystem::path& Path() const { return m_Path; }
+
+        private:
+            std::filesystem::path NextPath() const
+            {
+                std::filesystem::path next = m_Path;
+                next += ".next";
+                return next;
+            }
+
+            /* Finishes any rotation that has been swapped in then keeps the next file ready until stopped */
+            void RunRotation()
+            {
+                std::unique_lock lock(m_RotateMutex);
+                for (;;)
+                {
+                    if (m_Retired != nullptr)
+                    {
+                        std::unique_ptr<std::ofstream> retired = std::move(m_Retired);
+                        const unsigned retain = m_Config.retain;
+                        lock.unlock();
+
+                        /* The retired file is flushed here instead of by the writing thread */
+                        retired->close();
+                        ShiftRotatedFiles(m_Path, retain);
+
+                        /* The file that is now being written to keeps its handle when it is renamed */
+                        std::error_code error;
+                        std::filesystem::rename(NextPath(), m_Path, error);
+
+                        lock.lock();
+                        continue;
+                    }
+
+                    if (!m_Running)
+                        break;
+
+                    if (m_Next == nullptr)
+                    {
+                        lock.unlock();
+                        auto next = std::make_unique<std::ofstream>(NextPath(), std::ios::trunc);
+                        lock.lock();
+
+                        m_Next = std::move(next);
+                        continue;
+                    }
+
+                    m_RotateCondition.wait(lock, [this]() { return m_Retired != nullptr || !m_Running; });
+                }
+
+                /* The prepared file was never written to so it is removed */
+                if (m_Next != nullptr)
+                {
+                    m_Next.reset();
+
+                    std::error_code error;
+                    std::filesystem::remove(NextPath(), error);
+                }
+            }
+
+            const std::filesystem::path m_Path;
+
+            /* Only used whilst holding the sink lock, the config is only changed whilst also holding the rotate lock */
+            std::unique_ptr<std::ofstream> m_Current;
+            std::uint64_t m_Written = 0;
+            std::chrono::steady_clock::time_point m_OpenedAt;
+            LogRotationConfig m_Config;
+            std::atomic<bool> m_Rotating = false;
+
+            /* Handed between the writing thread and the rotation thread */
+            std::mutex m_RotateMutex;
+            std::condition_variable m_RotateCondition;
+            std::unique_ptr<std::ofstream> m_Next;
+            std::unique_ptr<std::ofstream> m_Retired;
+            bool m_Running = false;
+
+            std::thread m_Thread;
+            std::mutex m_ControlMutex;
+    };
+
+    /* Calls the function with each run of records whose text is next to each other in memory */
+    template<typename Func>
+    static void ForEachRun(std::span<const LogRecord> records, Func&& func)
+    {
+        std::size_t start = 0;
+        for (std::size_t index = 1; index <= records.size(); index++)
+        {
+            const LogRecord& last = records[index - 1];
+            if (index != records.size() && last.text.data() + last.text.size() == records[index].text.data())
+                continue;
+
+            const char* begin = records[start].text.data();
+            func(std::string_view(begin, static_cast<std::size_t>(last.text.data() + last.text.size() - begin)));
+            start = index;
+        }
+    }
+
+    void WriteToSink(LogSink& sink, std::span<const LogRecord> records, const std::shared_ptr<const std::string>& buffer)
+    {
+        const LogLevel level = sink.GetLevel();
+        const bool printed = sink.ReceivesPrinted();
+        const LogFormatter& formatter = sink.GetFormatter();
+
+        const auto accepted = [level, printed](const LogRecord& record)
+        {
+            return record.level >= level && (printed || !record.printed);
+        };
+
+        const std::size_t count = static_cast<std::size_t>(std::count_if(records.begin(), records.end(), accepted));
+        if (count == 0)
+            return;
+
+        /* The common case of every message being accepted as it is passes the records straight through */
+        if (count == records.size() && !formatter)
+        {
+            sink.Write(records, buffer);
+            return;
+        }
+
+        /* Not reused between calls as a sink can write to another sink whilst being written to */
+        std::vector<LogRecord> filtered;
+        filtered.reserve(count);
+
+        for (const LogRecord& record : records)
+        {
+            if (accepted(record))
+                filtered.push_back(record);
+        }
+
+        if (!formatter)
+        {
+            sink.Write(filtered, buffer);
+            return;
+        }
+
+        /* The views are set once everything is formatted as appending can move the text */
+        auto formatted = std::make_shared<std::string>();
+        std::vector<std::size_t> ends;
+        ends.reserve(count);
+
+        for (const LogRecord& record : filtered)
+        {
+            formatter(record, *formatted);
+            ends.push_back(formatted->size());
+        }
+
+        std::size_t start = 0;
+        for (std::size_t index = 0; index < count; index++)
+        {
+            filtered[index].text = std::string_view(formatted->data() + start, ends[index] - start);
+            start = ends[index];
+        }
+
+        sink.Write(filtered, formatted);
+    }
+}
+
+namespace PashaBibko::Util
+{
+    void ConsoleLogSink::Write(std::span<const LogRecord> records, const std::shared_ptr<const std::string>&)
+    {
+        std::size_t start = 0;
+        for (std::size_t index = 0; index <= records.size(); index++)
+        {
+            /* Uncoloured neighbouring messages are written together, coloured ones on their own */
+            if (index != records.size() && records[index].colour == Colour::Default)
+                continue;
+
+            Internal::ForEachRun(records.subspan(start, index - start), [](std::string_view text)
+            {
+                std::cout.write(text.data(), static_cast<std::streamsize>(text.size()));
+            });
+
+            if (index != records.size())
+            {
+                /* Coloured messages need the stream flushed before changing colour so it is applied in order */
+                const LogRecord& record = records[index];
+                std::cout.flush();
+                SetConsoleColor(record.colour);
+
+                std::cout.write(record.text.data(), static_cast<std::streamsize>(record.text.size()));
+
+                std::cout.flush();
+                SetConsoleColor(Colour::Default);
+            }
+
+            start = index + 1;
+        }
+
+        std::cout.flush();
+    }
+
+    void ConsoleLogSink::Flush()
+    {
+        std::cout.flush();
+    }
+
+    FileLogSink::FileLogSink(const std::filesystem::path& path, bool append)
+        : m_File(std::make_unique<Internal::RotatingFile>(path, append))
+    {}
+
+    FileLogSink::~FileLogSink() = default;
+
+    void FileLogSink::Write(std::span<const LogRecord> records, const std::shared_ptr<const std::string>&)
+    {
+        Internal::ForEachRun(records, [this](std::string_view text)
+        {
+            m_File->Write(text);
+        });
+
+        m_File->Flush();
+        m_File->RotateIfNeeded();
+    }
+
+    void FileLogSink::Flush()
+    {
+        m_File->Flush();
+    }
+
+    void FileLogSink::EnableRotation(const LogRotationConfig& config)
+    {
+        std::unique_lock lock = Internal::LockSinks();
+        m_File->EnableRotation(config);
+    }
+
+    void FileLogSink::DisableRotation()
+    {
+        m_File->DisableRotation();
+    }
+
+    const std::filesystem::path& FileLogSink::Path() const
+    {
+        return m_File->Path();
+    }
+
+    RingBufferLogSink::RingBufferLogSink(std::size_t capacity)
+        : m_Entries(std::max<std::size_t>(capacity, 1))
+    {}
+
+    void RingBufferLogSink::Write(std::span<const LogRecord> records, const std::shared_ptr<const std::string>& buffer)
+    {
+        std::lock_guard lock(m_Mutex);
+        bool spill = false;
+
+        for (const LogRecord& record : records)
+        {
+            Entry& entry = m_Entries[m_Next];
+            entry.record = record;
+
+            /* Keeps the shared buffer instead of copying, records without one are only valid during the call */
+            if (buffer != nullptr)
+                entry.buffer = buffer;
+
+            else
+            {
+                auto copy = std::make_shared<const std::string>(record.text);
+                entry.record.text = *copy;
+                entry.buffer = std::move(copy);
+            }
+
+            m_Next = (m_Next + 1) % m_Entries.size();
+            m_Count = std::min(m_Count + 1, m_Entries.size());
+            spill |= (record.level >= m_SpillTrigger);
+        }
+
+        if (spill && m_SpillTarget != nullptr)
+            SpillLocked(*m_SpillTarget);
+    }
+
+    void RingBufferLogSink::SetSpillTarget(std::shared_ptr<LogSink> target, LogLevel trigger)
+    {
+        std::unique_lock sinkLock = Internal::LockSinks();
+        std::lock_guard lock(m_Mutex);
+
+        m_SpillTarget = std::move(target);
+        m_SpillTrigger = trigger;
+    }
+
+    void RingBufferLogSink::Spill(LogSink& target)
+    {
+        std::unique_lock sinkLock = Internal::LockSinks();
+        std::lock_guard lock(m_Mutex);
+        SpillLocked(target);
+    }
+
+    void RingBufferLogSink::SpillLocked(LogSink& target)
+    {
+        std::vector<LogRecord> records;
+        records.reserve(m_Count);
+
+        const std::size_t first = (m_Next + m_Entries.size() - m_Count) % m_Entries.size();
+        for (std::size_t index = 0; index < m_Count; index++)
+            records.push_back(m_Entries[(first + index) % m_Entries.size()].record);
+
+        /* The records point into several buffers so none is passed, the target copies what it keeps */
+        Internal::WriteToSink(target, records, nullptr);
+
+        for (Entry& entry : m_Entries)
+            entry.buffer.reset();
+
+        m_Count = 0;
+    }
+
+    std::vector<std::string> RingBufferLogSink::Messages() const
+    {
+        std::lock_guard lock(m_Mutex);
+        std::vector<std::string> messages;
+        messages.reserve(m_Count);
+
+        const std::size_t first = (m_Next + m_Entries.size() - m_Count) % m_Entries.size();
+        for (std::size_t index = 0; index < m_Count; index++)
+            messages.emplace_back(m_Entries[(first + index) % m_Entries.size()].record.text);
+
+        return messages;
+    }
+}
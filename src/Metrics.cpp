@@ -0,0 +1,242 @@
+#include <sections/Metrics.h>
+
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <map>
+
+namespace PashaBibko::Util::Internal
+{
+    /* Metrics of one type by name, the library's own metrics are not owned by the registry */
+    template<typename Metric>
+    class MetricMap
+    {
+        public:
+            Metric& Get(std::string_view name)
+            {
+                auto it = m_Metrics.find(name);
+                if (it != m_Metrics.end())
+                    return *it->second;
+
+                Metric& metric = *m_Owned.emplace_back(std::make_unique<Metric>());
+                m_Metrics.emplace(std::string(name), &metric);
+                return metric;
+            }
+
+            void Add(std::string_view name, Metric& metric)
+            {
+                m_Metrics.emplace(std::string(name), &metric);
+            }
+
+            const std::map<std::string, Metric*, std::less<>>& All() const { return m_Metrics; }
+
+        private:
+            std::map<std::string, Metric*, std::less<>> m_Metrics;
+            std::vector<std::unique_ptr<Metric>> m_Owned;
+    };
+
+    class MetricRegistry
+    {
+        public:
+            MetricRegistry()
+            {
+                counters.Add("pbu.log.messages", logMessages);
+                counters.Add("pbu.log.bytes", logBytes);
+                counters.Add("pbu.file.reads", fileReads);
+                counters.Add("pbu.file.bytes_read", fileBytesRead);
+                counters.Add("pbu.returnval.failed", failedReturnVals);
+            }
+
+            std::mutex mutex;
+            MetricMap<Counter> counters;
+            MetricMap<Gauge> gauges;
+            MetricMap<Histogram> histograms;
+    };
+
+    /* Never destroyed so metrics can be used by other static objects during exit */
+    static MetricRegistry& Registry()
+    {
+        static MetricRegistry* registry = new MetricRegistry();
+        return *registry;
+    }
+
+    /* Prometheus names can only contain letters, digits, underscores and colons */
+    static std::string PrometheusName(std::string_view name)
+    {
+        std::string result(name);
+        for (char& c : result)
+        {
+            const bool valid = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c == ':';
+            if (!valid)
+                c = '_';
+        }
+
+        if (!result.empty() && result[0] >= '0' && result[0] <= '9')
+            result.insert(result.begin(), '_');
+
+        return result;
+    }
+}
+
+namespace PashaBibko::Util
+{
+    HistogramSnapshot Histogram::Snapshot() const
+    {
+        /* Copied first so the count and percentiles are calculated from the same values */
+        std::uint64_t buckets[BucketCount];
+        HistogramSnapshot snapshot;
+
+        for (std::size_t index = 0; index < BucketCount; index++)
+        {
+            buckets[index] = m_Buckets[index].load(std::memory_order_relaxed);
+            snapshot.count += buckets[index];
+        }
+
+        snapshot.sum = m_Sum.load(std::memory_order_relaxed);
+        if (snapshot.count == 0)
+            return snapshot;
+
+        /* The rank of each percentile, rounded up so p50 of 1 value is that value */
+        const auto rank = [&snapshot](double fraction)
+        {
+            return std::max<std::uint64_t>(1, static_cast<std::uint64_t>(fraction * static_cast<double>(snapshot.count) + 0.999999));
+        };
+
+        const std::uint64_t ranks[4] = { rank(0.50), rank(0.90), rank(0.99), rank(0.999) };
+        std::uint64_t* results[4] = { &snapshot.p50, &snapshot.p90, &snapshot.p99, &snapshot.p999 };
+
+        std::uint64_t seen = 0;
+        std::size_t next = 0;
+
+        for (std::size_t index = 0; index < BucketCount; index++)
+        {
+            if (buckets[index] == 0)
+                continue;
+
+            if (seen == 0)
+                snapshot.min = BucketLowest(index);
+
+            seen += buckets[index];
+            snapshot.max = BucketHighest(index);
+
+            while (next < 4 && seen >= ranks[next])
+                *results[next++] = BucketHighest(index);
+        }
+
+        return snapshot;
+    }
+
+    std::string MetricSnapshot::LogStr() const
+    {
+        switch (type)
+        {
+            case MetricType::Counter:   return name + " (counter) = " + std::to_string(value);
+            case MetricType::Gauge:     return name + " (gauge) = " + std::to_string(value);
+
+            default:
+                return name + " (histogram) count=" + std::to_string(histogram.count) +
+                    " sum=" + std::to_string(histogram.sum) +
+                    " min=" + std::to_string(histogram.min) +
+                    " p50=" + std::to_string(histogram.p50) +
+                    " p90=" + std::to_string(histogram.p90) +
+                    " p99=" + std::to_string(histogram.p99) +
+                    " p999=" + std::to_string(histogram.p999) +
+                    " max=" + std::to_string(histogram.max);
+        }
+    }
+
+    Counter& Metrics::GetCounter(std::string_view name)
+    {
+        Internal::MetricRegistry& registry = Internal::Registry();
+        std::lock_guard lock(registry.mutex);
+        return registry.counters.Get(name);
+    }
+
+    Gauge& Metrics::GetGauge(std::string_view name)
+    {
+        Internal::MetricRegistry& registry = Internal::Registry();
+        std::lock_guard lock(registry.mutex);
+        return registry.gauges.Get(name);
+    }
+
+    Histogram& Metrics::GetHistogram(std::string_view name)
+    {
+        Internal::MetricRegistry& registry = Internal::Registry();
+        std::lock_guard lock(registry.mutex);
+        return registry.histograms.Get(name);
+    }
+
+    std::vector<MetricSnapshot> Metrics::Snapshot()
+    {
+        Internal::MetricRegistry& registry = Internal::Registry();
+        std::vector<MetricSnapshot> snapshots;
+
+        {
+            std::lock_guard lock(registry.mutex);
+
+            for (const auto& [name, counter] : registry.counters.All())
+                snapshots.push_back({ name, MetricType::Counter, static_cast<std::int64_t>(counter->Value()), {} });
+
+            for (const auto& [name, gauge] : registry.gauges.All())
+                snapshots.push_back({ name, MetricType::Gauge, gauge->Value(), {} });
+
+            for (const auto& [name, histogram] : registry.histograms.All())
+                snapshots.push_back({ name, MetricType::Histogram, 0, histogram->Snapshot() });
+        }
+
+        std::stable_sort(snapshots.begin(), snapshots.end(), [](const MetricSnapshot& lhs, const MetricSnapshot& rhs)
+        {
+            return lhs.name < rhs.name;
+        });
+
+        return snapshots;
+    }
+
+    void Metrics::WriteText(std::ostream& out)
+    {
+        std::string text;
+
+        for (const MetricSnapshot& snapshot : Snapshot())
+        {
+            const std::string name = Internal::PrometheusName(snapshot.name);
+
+            switch (snapshot.type)
+            {
+                case MetricType::Counter:
+                    text += "# TYPE " + name + " counter\n" + name + " " + std::to_string(snapshot.value) + "\n";
+                    break;
+
+                case MetricType::Gauge:
+                    text += "# TYPE " + name + " gauge\n" + name + " " + std::to_string(snapshot.value) + "\n";
+                    break;
+
+                case MetricType::Histogram:
+                {
+                    const HistogramSnapshot& histogram = snapshot.histogram;
+                    text += "# TYPE " + name + " summary\n";
+                    text += name + "{quantile=\"0.5\"} " + std::to_string(histogram.p50) + "\n";
+                    text += name + "{quantile=\"0.9\"} " + std::to_string(histogram.p90) + "\n";
+                    text += name + "{quantile=\"0.99\"} " + std::to_string(histogram.p99) + "\n";
+                    text += name + "{quantile=\"0.999\"} " + std::to_string(histogram.p999) + "\n";
+                    text += name + "_sum " + std::to_string(histogram.sum) + "\n";
+                    text += name + "_count " + std::to_string(histogram.count) + "\n";
+                    break;
+                }
+            }
+        }
+
+        out.write(text.data(), static_cast<std::streamsize>(text.size()));
+        out.flush();
+    }
+
+    bool Metrics::WriteText(const std::filesystem::path& path)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file)
+            return false;
+
+        WriteText(file);
+        return static_cast<bool>(file);
+    }
+}
@@ -0,0 +1,319 @@
+#include <sections/FileRead.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <bit>
+
+/*
+ * Each kernel below finds '\n' characters a whole register at a time. SSE2 and NEON are
+ * always available on x86-64 and ARM64 so they are used as the baseline, AVX2 is only
+ * used if the CPU supports it which is checked the first time a function is called.
+ */
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #define PBU_NEWLINE_X86
+    #include <immintrin.h>
+
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #include <intrin.h>
+        #define PBU_TARGET_AVX2
+    #else
+        #define PBU_TARGET_AVX2 __attribute__((target("avx2")))
+    #endif
+
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    #define PBU_NEWLINE_NEON
+    #include <arm_neon.h>
+
+#endif
+
+namespace PashaBibko::Util::Internal
+{
+    /* The set of functions used by the current CPU */
+    struct NewLineKernels
+    {
+        std::size_t(*count)(const char*, const char*);
+        const char*(*find)(const char*, const char*);
+        const char*(*findLast)(const char*, const char*);
+        const char* name;
+    };
+
+    /* Scalar versions, used on other CPUs and for the bytes left over after the vector loops */
+
+    static std::size_t CountScalar(const char* begin, const char* end)
+    {
+        return static_cast<std::size_t>(std::count(begin, end, '\n'));
+    }
+
+    static const char* FindScalar(const char* begin, const char* end)
+    {
+        for (; begin != end; begin++)
+        {
+            if (*begin == '\n')
+                return begin;
+        }
+
+        return nullptr;
+    }
+
+    static const char* FindLastScalar(const char* begin, const char* end)
+    {
+        while (end != begin)
+        {
+            end--;
+            if (*end == '\n')
+                return end;
+        }
+
+        return nullptr;
+    }
+
+    #if defined(PBU_NEWLINE_X86)
+
+    static std::size_t CountSSE2(const char* begin, const char* end)
+    {
+        const __m128i newLine = _mm_set1_epi8('\n');
+        std::size_t count = 0;
+
+        while (end - begin >= 16)
+        {
+            /* Each byte counts up to 255 matches before they are summed, the compare returns -1 for matches */
+            std::size_t blocks = std::min<std::size_t>(static_cast<std::size_t>(end - begin) / 16, 255);
+            __m128i counts = _mm_setzero_si128();
+
+            for (; blocks != 0; blocks--, begin += 16)
+            {
+                const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+                counts = _mm_sub_epi8(counts, _mm_cmpeq_epi8(chunk, newLine));
+            }
+
+            const __m128i sums = _mm_sad_epu8(counts, _mm_setzero_si128());
+            count += static_cast<std::size_t>(_mm_cvtsi128_si32(sums) + _mm_cvtsi128_si32(_mm_srli_si128(sums, 8)));
+        }
+
+        return count + CountScalar(begin, end);
+    }
+
+    static const char* FindSSE2(const char* begin, const char* end)
+    {
+        const __m128i newLine = _mm_set1_epi8('\n');
+
+        for (; end - begin >= 16; begin += 16)
+        {
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+            const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newLine)));
+
+            if (mask != 0)
+                return begin + std::countr_zero(mask);
+        }
+
+        return FindScalar(begin, end);
+    }
+
+    static const char* FindLastSSE2(const char* begin, const char* end)
+    {
+        const __m128i newLine = _mm_set1_epi8('\n');
+
+        while (end - begin >= 16)
+        {
+            end -= 16;
+
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(end));
+            const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newLine)));
+
+            if (mask != 0)
+                return end + (std::bit_width(mask) - 1);
+        }
+
+        return FindLastScalar(begin, end);
+    }
+
+    PBU_TARGET_AVX2 static std::size_t CountAVX2(const char* begin, const char* end)
+    {
+        const __m256i newLine = _mm256_set1_epi8('\n');
+        std::size_t count = 0;
+
+        while (end - begin >= 32)
+        {
+            std::size_t blocks = std::min<std::size_t>(static_cast<std::size_t>(end - begin) / 32, 255);
+            __m256i counts = _mm256_setzero_si256();
+
+            for (; blocks != 0; blocks--, begin += 32)
+            {
+                const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin));
+                counts = _mm256_sub_epi8(counts, _mm256_cmpeq_epi8(chunk, newLine));
+            }
+
+            const __m256i wide = _mm256_sad_epu8(counts, _mm256_setzero_si256());
+            const __m128i sums = _mm_add_epi64(_mm256_castsi256_si128(wide), _mm256_extracti128_si256(wide, 1));
+            count += static_cast<std::size_t>(_mm_cvtsi128_si32(sums) + _mm_cvtsi128_si32(_mm_srli_si128(sums, 8)));
+        }
+
+        return count + CountScalar(begin, end);
+    }
+
+    PBU_TARGET_AVX2 static const char* FindAVX2(const char* begin, const char* end)
+    {
+        const __m256i newLine = _mm256_set1_epi8('\n');
+
+        for (; end - begin >= 32; begin += 32)
+        {
+            const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin));
+            const unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, newLine)));
+
+            if (mask != 0)
+                return begin + std::countr_zero(mask);
+        }
+
+        return FindScalar(begin, end);
+    }
+
+    PBU_TARGET_AVX2 static const char* FindLastAVX2(const char* begin, const char* end)
+    {
+        const __m256i newLine = _mm256_set1_epi8('\n');
+
+        while (end - begin >= 32)
+        {
+            end -= 32;
+
+            const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(end));
+            const unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, newLine)));
+
+            if (mask != 0)
+                return end + (std::bit_width(mask) - 1);
+        }
+
+        return FindLastScalar(begin, end);
+    }
+
+    static bool SupportsAVX2()
+    {
+        #if defined(_MSC_VER) && !defined(__clang__)
+            /* AVX2 needs both the CPU to support it and the OS to save the registers */
+            int info[4];
+            __cpuid(info, 0);
+            if (info[0] < 7)
+                return false;
+
+            __cpuid(info, 1);
+            const bool osSaves = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0;
+            if (!osSaves || (_xgetbv(0) & 0x6) != 0x6)
+                return false;
+
+            __cpuidex(info, 7, 0);
+            return (info[1] & (1 << 5)) != 0;
+
+        #else
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2");
+
+        #endif
+    }
+
+    #elif defined(PBU_NEWLINE_NEON)
+
+    /* NEON has no movemask, narrowing the compare result gives 4 bits for each byte instead */
+    static std::uint64_t NewLineMask(const char* chunk, uint8x16_t newLine)
+    {
+        const uint8x16_t matches = vceqq_u8(vld1q_u8(reinterpret_cast<const std::uint8_t*>(chunk)), newLine);
+        return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(matches), 4)), 0);
+    }
+
+    static std::size_t CountNEON(const char* begin, const char* end)
+    {
+        const uint8x16_t newLine = vdupq_n_u8('\n');
+        std::size_t count = 0;
+
+        while (end - begin >= 16)
+        {
+            /* Each byte counts up to 255 matches before they are summed, the compare returns 0xFF for matches */
+            std::size_t blocks = std::min<std::size_t>(static_cast<std::size_t>(end - begin) / 16, 255);
+            uint8x16_t counts = vdupq_n_u8(0);
+
+            for (; blocks != 0; blocks--, begin += 16)
+            {
+                const uint8x16_t chunk = vld1q_u8(reinterpret_cast<const std::uint8_t*>(begin));
+                counts = vsubq_u8(counts, vceqq_u8(chunk, newLine));
+            }
+
+            count += vaddvq_u16(vpaddlq_u8(counts));
+        }
+
+        return count + CountScalar(begin, end);
+    }
+
+    static const char* FindNEON(const char* begin, const char* end)
+    {
+        const uint8x16_t newLine = vdupq_n_u8('\n');
+
+        for (; end - begin >= 16; begin += 16)
+        {
+            const std::uint64_t mask = NewLineMask(begin, newLine);
+            if (mask != 0)
+                return begin + (std::countr_zero(mask) / 4);
+        }
+
+        return FindScalar(begin, end);
+    }
+
+    static const char* FindLastNEON(const char* begin, const char* end)
+    {
+        const uint8x16_t newLine = vdupq_n_u8('\n');
+
+        while (end - begin >= 16)
+        {
+            end -= 16;
+
+            const std::uint64_t mask = NewLineMask(end, newLine);
+            if (mask != 0)
+                return end + ((std::bit_width(mask) - 1) / 4);
+        }
+
+        return FindLastScalar(begin, end);
+    }
+
+    #endif
+
+    static NewLineKernels SelectKernels()
+    {
+        #if defined(PBU_NEWLINE_X86)
+            if (SupportsAVX2())
+                return { CountAVX2, FindAVX2, FindLastAVX2, "avx2" };
+
+            return { CountSSE2, FindSSE2, FindLastSSE2, "sse2" };
+
+        #elif defined(PBU_NEWLINE_NEON)
+            return { CountNEON, FindNEON, FindLastNEON, "neon" };
+
+        #else
+            return { CountScalar, FindScalar, FindLastScalar, "scalar" };
+
+        #endif
+    }
+
+    static const NewLineKernels& Kernels()
+    {
+        static const NewLineKernels kernels = SelectKernels();
+        return kernels;
+    }
+
+    std::size_t CountNewLines(const char* begin, const char* end)
+    {
+        return Kernels().count(begin, end);
+    }
+
+    const char* FindNewLine(const char* begin, const char* end)
+    {
+        return Kernels().find(begin, end);
+    }
+
+    const char* FindLastNewLine(const char* begin, const char* end)
+    {
+        return Kernels().findLast(begin, end);
+    }
+
+    const char* NewLineScanKernel()
+    {
+        return Kernels().name;
+    }
+}
@@ -0,0 +1,351 @@
+#include <sections/Trace.h>
+
+#include <unordered_map>
+#include <algorithm>
+#include <fstream>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+
+namespace PashaBibko::Util::Internal
+{
+    struct TraceRecord
+    {
+        const char* name;
+        std::uint64_t start;
+        std::uint64_t end;
+    };
+
+    /* Records are stored in fixed size blocks so the ones already written never move */
+    struct TraceBlock
+    {
+        static constexpr std::size_t capacity = 4096;
+
+        TraceRecord records[capacity];
+        std::unique_ptr<TraceBlock> next;
+    };
+
+    /*
+     * Written to by a single thread and read by whoever exports the trace. The writer publishes
+     * how many records it has written after writing them so the reader never sees a partial one.
+     */
+    class TraceBuffer
+    {
+        public:
+            explicit TraceBuffer(std::size_t index)
+                : m_Index(index), m_Head(std::make_unique<TraceBlock>()), m_Current(m_Head.get())
+            {}
+
+            /* Returns false if the buffer already holds the limit */
+            bool Push(const TraceRecord& record, std::size_t limit)
+            {
+                const std::size_t count = m_Count.load(std::memory_order_relaxed);
+                if (count >= limit)
+                    return false;
+
+                const std::size_t offset = count % TraceBlock::capacity;
+                if (offset == 0 && count != 0)
+                {
+                    m_Current->next = std::make_unique<TraceBlock>();
+                    m_Current = m_Current->next.get();
+                }
+
+                m_Current->records[offset] = record;
+                m_Count.store(count + 1, std::memory_order_release);
+                return true;
+            }
+
+            /* Calls the function with each record published so far */
+            template<typename Func>
+            void ForEach(Func&& func) const
+            {
+                const std::size_t count = m_Count.load(std::memory_order_acquire);
+                const TraceBlock* block = m_Head.get();
+
+                for (std::size_t index = 0; index < count; index++)
+                {
+                    if (index != 0 && index % TraceBlock::capacity == 0)
+                        block = block->next.get();
+
+                    func(block->records[index % TraceBlock::capacity]);
+                }
+            }
+
+            /* Only safe when the owning thread is not recording */
+            void Clear()
+            {
+                m_Head->next.reset();
+                m_Current = m_Head.get();
+                m_Count.store(0, std::memory_order_release);
+            }
+
+            std::size_t Index() const { return m_Index; }
+
+            /* Set by the owning thread, read whilst holding the list lock */
+            std::string name;
+
+        private:
+            const std::size_t m_Index;
+
+            std::unique_ptr<TraceBlock> m_Head;
+            TraceBlock* m_Current;
+            std::atomic<std::size_t> m_Count = 0;
+    };
+
+    /* Owns the buffer of every thread that has recorded a zone, including ones that have exited */
+    class Tracer
+    {
+        public:
+            std::shared_ptr<TraceBuffer> CreateBuffer()
+            {
+                std::lock_guard lock(m_Mutex);
+
+                auto buffer = std::make_shared<TraceBuffer>(m_NextIndex++);
+                m_Buffers.push_back(buffer);
+                return buffer;
+            }
+
+            /* Clears the buffers of running threads and drops the ones only the tracer holds as their thread has exited */
+            void ClearBuffers()
+            {
+                std::lock_guard lock(m_Mutex);
+                std::erase_if(m_Buffers, [](const std::shared_ptr<TraceBuffer>& buffer) { return buffer.use_count() == 1; });
+
+                for (const std::shared_ptr<TraceBuffer>& buffer : m_Buffers)
+                    buffer->Clear();
+            }
+
+            /* Copies the list so the lock is not held whilst reading the records */
+            std::vector<std::shared_ptr<TraceBuffer>> Buffers()
+            {
+                std::lock_guard lock(m_Mutex);
+                return m_Buffers;
+            }
+
+            void SetThreadName(TraceBuffer& buffer, std::string_view name)
+            {
+                std::lock_guard lock(m_Mutex);
+                buffer.name = name;
+            }
+
+            std::string ThreadName(const TraceBuffer& buffer)
+            {
+                std::lock_guard lock(m_Mutex);
+                return buffer.name.empty() ? "Thread " + std::to_string(buffer.Index()) : buffer.name;
+            }
+
+            std::atomic<std::size_t> maxZones = TraceConfig{}.maxZonesPerThread;
+            std::atomic<std::size_t> dropped = 0;
+            std::atomic<std::uint64_t> startTime = 0;
+
+        private:
+            std::mutex m_Mutex;
+            std::vector<std::shared_ptr<TraceBuffer>> m_Buffers;
+
+            /* Not the size of the list as dropped buffers would let two threads share an index */
+            std::size_t m_NextIndex = 0;
+    };
+
+    /* Never destroyed so zones that end during static destruction can still be recorded */
+    static Tracer& GetTracer()
+    {
+        static Tracer* tracer = new Tracer();
+        return *tracer;
+    }
+
+    /* The calling thread's buffer, kept alive by the tracer after the thread exits so it can be exported */
+    static thread_local std::shared_ptr<TraceBuffer> threadBuffer;
+
+    static TraceBuffer& ThreadBuffer()
+    {
+        if (threadBuffer == nullptr)
+            threadBuffer = GetTracer().CreateBuffer();
+
+        return *threadBuffer;
+    }
+
+    void RecordTraceZone(const char* name, std::uint64_t start, std::uint64_t end)
+    {
+        Tracer& tracer = GetTracer();
+        if (!ThreadBuffer().Push({ name, start, end }, tracer.maxZones.load(std::memory_order_relaxed)))
+            tracer.dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static void AppendJsonString(std::string& out, std::string_view str)
+    {
+        out.push_back('"');
+        for (const char c : str)
+        {
+            if (c == '"' || c == '\\')
+            {
+                out.push_back('\\');
+                out.push_back(c);
+            }
+
+            else if (static_cast<unsigned char>(c) < 0x20)
+            {
+                char escaped[8];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(c));
+                out.append(escaped);
+            }
+
+            else
+                out.push_back(c);
+        }
+
+        out.push_back('"');
+    }
+
+    /* Chrome expects microseconds, the fraction keeps the nanoseconds */
+    static void AppendMicroseconds(std::string& out, std::uint64_t nanoseconds)
+    {
+        char text[32];
+        std::snprintf(text, sizeof(text), "%llu.%03llu",
+            static_cast<unsigned long long>(nanoseconds / 1000), static_cast<unsigned long long>(nanoseconds % 1000));
+
+        out.append(text);
+    }
+}
+
+namespace PashaBibko::Util
+{
+    void StartTracing(const TraceConfig& config)
+    {
+        Internal::Tracer& tracer = Internal::GetTracer();
+        tracer.maxZones.store(config.maxZonesPerThread, std::memory_order_relaxed);
+
+        /* Keeps the start of the first session so timestamps stay positive across sessions */
+        std::uint64_t expected = 0;
+        tracer.startTime.compare_exchange_strong(expected, Internal::TraceNow(), std::memory_order_relaxed);
+
+        Internal::tracingActive.store(true, std::memory_order_release);
+    }
+
+    void StopTracing()
+    {
+        Internal::tracingActive.store(false, std::memory_order_release);
+    }
+
+    void ClearTrace()
+    {
+        Internal::Tracer& tracer = Internal::GetTracer();
+        tracer.ClearBuffers();
+
+        tracer.dropped.store(0, std::memory_order_relaxed);
+        tracer.startTime.store(Internal::tracingActive.load(std::memory_order_relaxed) ? Internal::TraceNow() : 0, std::memory_order_relaxed);
+    }
+
+    std::size_t DroppedTraceZoneCount()
+    {
+        return Internal::GetTracer().dropped.load(std::memory_order_relaxed);
+    }
+
+    void SetTraceThreadName(std::string_view name)
+    {
+        Internal::GetTracer().SetThreadName(Internal::ThreadBuffer(), name);
+    }
+
+    std::string TraceZoneSummary::LogStr() const
+    {
+        return name + ": count=" + std::to_string(count) +
+            " total=" + std::to_string(total.count()) + "ns" +
+            " min=" + std::to_string(min.count()) + "ns" +
+            " avg=" + std::to_string(avg.count()) + "ns" +
+            " p99=" + std::to_string(p99.count()) + "ns" +
+            " max=" + std::to_string(max.count()) + "ns";
+    }
+
+    std::vector<TraceZoneSummary> TraceZoneStats()
+    {
+        /* Zones are grouped by their text as the same literal can have different addresses */
+        std::unordered_map<std::string_view, std::vector<std::uint64_t>> durations;
+        for (const std::shared_ptr<Internal::TraceBuffer>& buffer : Internal::GetTracer().Buffers())
+        {
+            buffer->ForEach([&durations](const Internal::TraceRecord& record)
+            {
+                durations[record.name].push_back(record.end - record.start);
+            });
+        }
+
+        std::vector<TraceZoneSummary> summaries;
+        summaries.reserve(durations.size());
+
+        for (auto& [name, times] : durations)
+        {
+            std::sort(times.begin(), times.end());
+
+            std::uint64_t total = 0;
+            for (const std::uint64_t time : times)
+                total += time;
+
+            TraceZoneSummary& summary = summaries.emplace_back();
+            summary.name = name;
+            summary.count = times.size();
+            summary.total = std::chrono::nanoseconds(total);
+            summary.min = std::chrono::nanoseconds(times.front());
+            summary.avg = std::chrono::nanoseconds(total / times.size());
+            summary.p99 = std::chrono::nanoseconds(times[(times.size() - 1) * 99 / 100]);
+            summary.max = std::chrono::nanoseconds(times.back());
+        }
+
+        std::sort(summaries.begin(), summaries.end(), [](const TraceZoneSummary& lhs, const TraceZoneSummary& rhs)
+        {
+            return lhs.total > rhs.total;
+        });
+
+        return summaries;
+    }
+
+    void WriteChromeTrace(std::ostream& out)
+    {
+        Internal::Tracer& tracer = Internal::GetTracer();
+        const std::uint64_t startTime = tracer.startTime.load(std::memory_order_relaxed);
+
+        std::string text = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+        bool first = true;
+
+        for (const std::shared_ptr<Internal::TraceBuffer>& buffer : tracer.Buffers())
+        {
+            const std::string tid = std::to_string(buffer->Index());
+
+            /* Metadata event so viewers show the name of the thread instead of its index */
+            text.append(first ? "\n" : ",\n");
+            text.append("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + tid + ",\"args\":{\"name\":");
+            Internal::AppendJsonString(text, tracer.ThreadName(*buffer));
+            text.append("}}");
+            first = false;
+
+            buffer->ForEach([&](const Internal::TraceRecord& record)
+            {
+                text.append(",\n{\"name\":");
+                Internal::AppendJsonString(text, record.name);
+                text.append(",\"cat\":\"PBU\",\"ph\":\"X\",\"ts\":");
+                Internal::AppendMicroseconds(text, record.start >= startTime ? record.start - startTime : 0);
+                text.append(",\"dur\":");
+                Internal::AppendMicroseconds(text, record.end - record.start);
+                text.append(",\"pid\":1,\"tid\":" + tid + "}");
+
+                /* Writes in chunks so large traces do not need to fit in memory twice */
+                if (text.size() > (1 << 20))
+                {
+                    out.write(text.data(), static_cast<std::streamsize>(text.size()));
+                    text.clear();
+                }
+            });
+        }
+
+        text.append("\n]}\n");
+        out.write(text.data(), static_cast<std::streamsize>(text.size()));
+        out.flush();
+    }
+
+    bool WriteChromeTrace(const std::filesystem::path& path)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file)
+            return false;
+
+        WriteChromeTrace(file);
+        return static_cast<bool>(file);
+    }
+}